@@ -0,0 +1,501 @@
+#include "francis.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+#include "hessenberg.h"
+#include "parallel.h"
+
+using Complex = std::complex<double>;
+
+// Windows of this size and larger are swept with several shifts at once
+constexpr int kMultishift = 75;
+
+// P = I - tau v v^T with v = (1, v1, v2), P (x, y, z)^T = (beta, 0, 0)^T
+struct Reflector {
+  double v1 = 0;
+  double v2 = 0;
+  double tau = 0;
+  double beta = 0;
+};
+
+Reflector MakeReflector(double x, double y, double z) {
+  Reflector P;
+  double sigma = y * y + z * z;
+  P.beta = x;
+  if (sigma == 0)
+    return P;
+  P.beta = -std::copysign(sqrt(x * x + sigma), x);
+  double scale = 1 / (x - P.beta);
+  P.v1 = y * scale;
+  P.v2 = z * scale;
+  P.tau = (P.beta - x) / P.beta;
+  return P;
+}
+
+// P from the left on rows x, y (and z) of length n
+void ApplyLeft(const Reflector &P, double *x, double *y, double *z, int n) {
+  if (z)
+    for (int c = 0; c < n; ++c) {
+      double s = P.tau * (x[c] + P.v1 * y[c] + P.v2 * z[c]);
+      x[c] -= s;
+      y[c] -= s * P.v1;
+      z[c] -= s * P.v2;
+    }
+  else
+    for (int c = 0; c < n; ++c) {
+      double s = P.tau * (x[c] + P.v1 * y[c]);
+      x[c] -= s;
+      y[c] -= s * P.v1;
+    }
+}
+
+// P from the right on `size` adjacent columns starting at a, for `rows`
+// rows `stride` apart
+void ApplyRight(const Reflector &P, double *a, int size, int rows,
+                int stride) {
+  for (int r = 0; r < rows; ++r, a += stride) {
+    double s = a[0] + P.v1 * a[1];
+    if (size == 3)
+      s += P.v2 * a[2];
+    s *= P.tau;
+    a[0] -= s;
+    a[1] -= s * P.v1;
+    if (size == 3)
+      a[2] -= s * P.v2;
+  }
+}
+
+// Window of the chase and the orthogonal matrix U collecting its
+// reflectors, rows of U are `width` apart and its column 0 stands for
+// column begin of H. Left reflectors reach columns up to end - 1 and right
+// ones rows from begin, the rest of the window is left to the caller.
+struct Chase {
+  Matrix &H;
+  int lo;
+  int hi;
+  int begin;
+  int end;
+  double *U = nullptr;
+  int width = 0;
+  int rows = 0;
+};
+
+// Moves the bulge of the shifts x^2 - sum x + product to position p: the
+// reflector at rows p .. p + 2 is made from the first column of
+// (H - s1)(H - s2) at p == lo, from column p - 1 otherwise
+void Bulge(const Chase &chase, int p, double sum, double product) {
+  Matrix &H = chase.H;
+  int size = std::min(3, chase.hi - p);
+  double x, y, z;
+  if (p == chase.lo) {
+    double h00 = H[{p, p}];
+    double h10 = H[{p, p + 1}];
+    double h11 = H[{p + 1, p + 1}];
+    x = h00 * h00 + H[{p + 1, p}] * h10 - sum * h00 + product;
+    y = h10 * (h00 + h11 - sum);
+    z = h10 * H[{p + 1, p + 2}];
+  } else {
+    x = H[{p - 1, p}];
+    y = H[{p - 1, p + 1}];
+    z = size == 3 ? H[{p - 1, p + 2}] : 0.0;
+  }
+  Reflector P = MakeReflector(x, y, z);
+  if (P.tau == 0)
+    return;
+
+  int first = std::max(chase.lo, p - 1);
+  ApplyLeft(P, &H[{first, p}], &H[{first, p + 1}],
+            size == 3 ? &H[{first, p + 2}] : nullptr, chase.end - first);
+  if (p > chase.lo) {
+    H[{p - 1, p}] = P.beta;
+    H[{p - 1, p + 1}] = 0;
+    if (size == 3)
+      H[{p - 1, p + 2}] = 0;
+  }
+  // Views have rows further apart than cols()
+  int stride = &H[{0, 1}] - &H[{0, 0}];
+  int last = std::min(p + 4, chase.hi);
+  ApplyRight(P, &H[{p, chase.begin}], size, last - chase.begin, stride);
+  if (chase.U)
+    ApplyRight(P, chase.U + (p - chase.begin), size, chase.rows,
+               chase.width);
+}
+
+void Solver::FrancisStep(Matrix &H, int lo, int hi, double sum,
+                         double product, Matrix *Q) {
+  Chase chase{H, lo, hi, lo, hi};
+  if (Q) {
+    chase.begin = 0;
+    chase.end = H.cols();
+    chase.U = &(*Q)[{0, 0}];
+    chase.width = &(*Q)[{0, 1}] - &(*Q)[{0, 0}];
+    chase.rows = Q->rows();
+  }
+  for (int p = lo; p < hi - 1; ++p)
+    Bulge(chase, p, sum, product);
+}
+
+// c = a b, a is m x K with the element (i, k) at a[i * ai + k * ak], b and c
+// are by rows ldb and ldc apart. Four rows of c are formed at once, so every
+// row of b loaded is used four times.
+void Multiply(const double *a, int ai, int ak, const double *b, int ldb,
+              double *c, int ldc, int m, int K, int n) {
+  int i = 0;
+  for (; i + 4 <= m; i += 4) {
+    double *c0 = c + i * ldc;
+    double *c1 = c0 + ldc;
+    double *c2 = c1 + ldc;
+    double *c3 = c2 + ldc;
+    for (int j = 0; j < n; ++j)
+      c0[j] = c1[j] = c2[j] = c3[j] = 0;
+    for (int k = 0; k < K; ++k) {
+      const double *x = a + i * ai + k * ak;
+      double a0 = x[0], a1 = x[ai], a2 = x[2 * ai], a3 = x[3 * ai];
+      if (a0 == 0 && a1 == 0 && a2 == 0 && a3 == 0)
+        continue;
+      const double *bk = b + k * ldb;
+      for (int j = 0; j < n; ++j) {
+        c0[j] += a0 * bk[j];
+        c1[j] += a1 * bk[j];
+        c2[j] += a2 * bk[j];
+        c3[j] += a3 * bk[j];
+      }
+    }
+  }
+  for (; i < m; ++i) {
+    double *ci = c + i * ldc;
+    std::fill(ci, ci + n, 0.0);
+    for (int k = 0; k < K; ++k) {
+      double x = a[i * ai + k * ak];
+      if (x == 0)
+        continue;
+      const double *bk = b + k * ldb;
+      for (int j = 0; j < n; ++j)
+        ci[j] += x * bk[j];
+    }
+  }
+}
+
+void Solver::MultishiftSweep(Matrix &H, int lo, int hi,
+                             const std::vector<std::complex<double>> &shifts,
+                             int workers) {
+  std::vector<double> sum, product;
+  for (size_t k = 0; k + 1 < shifts.size(); k += 2) {
+    sum.push_back((shifts[k] + shifts[k + 1]).real());
+    product.push_back((shifts[k] * shifts[k + 1]).real());
+  }
+  int bulges = sum.size();
+  if (bulges == 0 || hi - lo < 3)
+    return;
+
+  // At step g bulge b is at p = lo + g - 3 b, the chain moves down by
+  // `chunk` steps per block
+  int steps = hi - 1 - lo + 3 * (bulges - 1);
+  int chunk = std::max(3 * bulges, 16);
+  std::vector<double> U;
+  for (int g0 = 0; g0 < steps; g0 += chunk) {
+    int g1 = std::min(steps, g0 + chunk);
+    int pmin = std::max(lo, lo + g0 - 3 * (bulges - 1));
+    int pmax = std::min(hi - 2, lo + g1 - 1);
+    int begin = std::max(lo, pmin - 1);
+    int end = std::min(hi, pmax + 4);
+    int w = end - begin;
+    U.assign(w * w, 0.0);
+    for (int i = 0; i < w; ++i)
+      U[i * w + i] = 1;
+
+    Chase chase{H, lo, hi, begin, end, U.data(), w, w};
+    for (int g = g0; g < g1; ++g)
+      for (int b = 0; b < bulges; ++b) {
+        int p = lo + g - 3 * b;
+        if (p >= lo && p < hi - 1)
+          Bulge(chase, p, sum[b], product[b]);
+      }
+
+    // Rows begin .. end - 1 right of the block get U^T from the left,
+    // columns begin .. end - 1 above it get U from the right
+    int stride = &H[{0, 1}] - &H[{0, 0}];
+    Parallel(workers, [&](int worker) {
+      int first, last;
+      Share(worker, workers, end, hi, first, last);
+      int n = last - first;
+      std::vector<double> block(w * n);
+      if (n > 0) {
+        double *b = &H[{first, begin}];
+        Multiply(U.data(), 1, w, b, stride, block.data(), n, w, w, n);
+        for (int i = 0; i < w; ++i)
+          std::copy(&block[i * n], &block[i * n] + n, b + i * stride);
+      }
+      Share(worker, workers, lo, begin, first, last);
+      n = last - first;
+      block.resize(n * w);
+      if (n > 0) {
+        double *a = &H[{begin, first}];
+        Multiply(a, stride, 1, U.data(), w, block.data(), w, n, w, w);
+        for (int r = 0; r < n; ++r)
+          std::copy(&block[r * w], &block[r * w] + w, a + r * stride);
+      }
+    });
+  }
+}
+
+// Eigenvalues of the 2 x 2 block at rows and columns k, k + 1
+void Block(const Matrix &H, int k, Complex &first, Complex &second) {
+  double a = H[{k, k}];
+  double b = H[{k + 1, k}];
+  double c = H[{k, k + 1}];
+  double d = H[{k + 1, k + 1}];
+  double half = (a - d) / 2;
+  double disc = half * half + b * c;
+  if (disc < 0) {
+    first = Complex(d + half, sqrt(-disc));
+    second = std::conj(first);
+    return;
+  }
+  // The root of larger modulus first, the other from the determinant
+  double root = half + std::copysign(sqrt(disc), half);
+  first = d + root;
+  second = root != 0 ? d - b * c / root : d;
+}
+
+bool Negligible(double h, double near) {
+  return std::abs(h) <= std::numeric_limits<double>::epsilon() * near ||
+         std::abs(h) < std::numeric_limits<double>::min();
+}
+
+bool Negligible(const Matrix &H, int l) {
+  return Negligible(H[{l - 1, l}],
+                    std::abs(H[{l - 1, l - 1}]) + std::abs(H[{l, l}]));
+}
+
+int Solver::AggressiveDeflation(Matrix &H, int lo, int hi, int nw,
+                                std::vector<Complex> &values) {
+  int top = hi - nw;
+  if (top <= lo || nw < 2)
+    return 0;
+  double spike = H[{top - 1, top}];
+  Matrix T(nw, [&H, top](int c, int r) {
+    return c + 1 < r ? 0.0 : H[{top + c, top + r}];
+  });
+  Matrix V(nw, [](int c, int r) { return c == r ? 1.0 : 0.0; });
+  std::vector<Complex> local(nw);
+  Schur(T, 0, nw, local, nullptr, 1, &V);
+
+  // Rows kept .. nw - 1 of T split off
+  int kept = nw;
+  while (kept > 0) {
+    int j = kept - 1;
+    bool pair = j > 0 && T[{j - 1, j}] != 0;
+    double near = std::abs(T[{j, j}]);
+    double s = std::abs(spike * V[{j, 0}]);
+    if (pair) {
+      near += sqrt(std::abs(T[{j - 1, j}])) * sqrt(std::abs(T[{j, j - 1}]));
+      s = std::max(s, std::abs(spike * V[{j - 1, 0}]));
+    }
+    if (!Negligible(s, near))
+      break;
+    kept -= pair ? 2 : 1;
+  }
+  int found = nw - kept;
+  if (found == 0)
+    return 0;
+  for (int j = kept; j < nw; ++j)
+    values[top + j] = local[j];
+
+  // The spike and the kept part of T are returned to Hessenberg form, with
+  // the spike as column 0 of M; the reflectors join V
+  Matrix M(kept + 1, [&](int c, int r) {
+    if (r == 0)
+      return 0.0;
+    return c == 0 ? spike * V[{r - 1, 0}] : T[{c - 1, r - 1}];
+  });
+  std::vector<double> tau;
+  if (kept > 1)
+    ReduceHessenberg(M, tau);
+  for (int j = 0; j + 2 <= kept && j < static_cast<int>(tau.size()); ++j) {
+    if (tau[j] == 0)
+      continue;
+    // v(j + 1) = 1, v(r) = M(r, j) below; M index r is T index r - 1
+    auto v = [&M, j](int r) { return r == j + 1 ? 1.0 : M[{j, r}]; };
+    for (int i = 0; i < nw; ++i) {
+      double s = 0;
+      for (int r = j + 1; r <= kept; ++r)
+        s += V[{r - 1, i}] * v(r);
+      s *= tau[j];
+      for (int r = j + 1; r <= kept; ++r)
+        V[{r - 1, i}] -= s * v(r);
+    }
+    for (int c = kept; c < nw; ++c) {
+      double s = 0;
+      for (int r = j + 1; r <= kept; ++r)
+        s += T[{c, r - 1}] * v(r);
+      s *= tau[j];
+      for (int r = j + 1; r <= kept; ++r)
+        T[{c, r - 1}] -= s * v(r);
+    }
+  }
+
+  // The block, then the columns above it get V
+  for (int r = 0; r < nw; ++r)
+    for (int c = 0; c < nw; ++c) {
+      double h = 0;
+      if (r < kept && c < kept)
+        h = c + 1 < r ? 0.0 : M[{c + 1, r + 1}];
+      else if (c >= kept)
+        h = T[{c, r}];
+      H[{top + c, top + r}] = h;
+    }
+  H[{top - 1, top}] = kept > 0 ? M[{0, 1}] : 0.0;
+  std::vector<double> row(nw);
+  for (int r = lo; r < top; ++r) {
+    double *a = &H[{top, r}];
+    std::fill(row.begin(), row.end(), 0.0);
+    for (int k = 0; k < nw; ++k)
+      for (int j = 0; j < nw; ++j)
+        row[j] += a[k] * V[{j, k}];
+    std::copy(row.begin(), row.end(), a);
+  }
+  return found;
+}
+
+// Shifts of a multishift sweep: the eigenvalues of the trailing m x m block
+// of the window, conjugate pairs first and real ones paired in order
+std::vector<Complex> Shifts(const Matrix &H, int hi, int m) {
+  Matrix T(m, [&H, hi, m](int c, int r) {
+    return c + 1 < r ? 0.0 : H[{hi - m + c, hi - m + r}];
+  });
+  std::vector<Complex> values(m), shifts, real;
+  Solver::Schur(T, 0, m, values);
+  for (int i = 0; i < m; ++i)
+    if (values[i].imag() != 0) {
+      shifts.push_back(values[i]);
+      shifts.push_back(values[++i]);
+    } else {
+      real.push_back(values[i]);
+    }
+  shifts.insert(shifts.end(), real.begin(), real.end());
+  return shifts;
+}
+
+// Roots of x^2 - sum x + product
+std::vector<Complex> Roots(double sum, double product) {
+  double half = sum / 2;
+  double discriminant = half * half - product;
+  if (discriminant >= 0) {
+    double root = std::sqrt(discriminant);
+    return {half + root, half - root};
+  }
+  double root = std::sqrt(-discriminant);
+  return {Complex(half, root), Complex(half, -root)};
+}
+
+// Francis double-shift steps, or aggressive deflation and multishift sweeps
+// on large windows, run on the active window, which shrinks from below as
+// 1 x 1 and 2 x 2 blocks split off
+void Solver::Schur(Matrix &H, int bottom, int hi, std::vector<Complex> &values,
+                   EigenReport *report, int workers, Matrix *Q) {
+  using Clock = std::chrono::steady_clock;
+  int N = hi - bottom;
+  int iteration = 0;
+  int since = 0;
+  const EigenObserver *observer =
+      report && report->observer ? &report->observer : nullptr;
+  auto last = Clock::now();
+  auto notify = [&](EigenEvent::Kind kind, int lo, int end,
+                    std::vector<Complex> shifts) {
+    EigenEvent event;
+    event.kind = kind;
+    event.iteration = iteration;
+    event.lo = lo;
+    event.hi = end;
+    double sum = 0;
+    for (int i = bottom + 1; i < hi; ++i)
+      sum += H[{i - 1, i}] * H[{i - 1, i}];
+    event.subdiagonal = std::sqrt(sum);
+    event.shifts = std::move(shifts);
+    if (kind == EigenEvent::Kind::Deflation)
+      event.values.assign(values.begin() + lo, values.begin() + end);
+    auto now = Clock::now();
+    event.seconds = std::chrono::duration<double>(now - last).count();
+    last = now;
+    (*observer)(event);
+  };
+  auto deflate = [&](int count) {
+    hi -= count;
+    if (report)
+      report->steps.insert(report->steps.end(), count, since);
+    since = 0;
+    if (observer)
+      notify(EigenEvent::Kind::Deflation, hi, hi + count, {});
+  };
+  while (hi > bottom) {
+    int lo = hi - 1;
+    while (lo > bottom && !Negligible(H, lo))
+      --lo;
+    if (lo > bottom)
+      H[{lo - 1, lo}] = 0;
+
+    if (lo == hi - 1) {
+      values[lo] = H[{lo, lo}];
+      deflate(1);
+      continue;
+    }
+    if (lo == hi - 2) {
+      Block(H, lo, values[lo], values[lo + 1]);
+      deflate(2);
+      continue;
+    }
+
+    if (iteration == 1000 * N)
+      throw std::runtime_error("Solver error # 4");
+    int size = hi - lo;
+    int m = size < kMultishift || Q
+                ? 2
+                : std::min(64, std::max(4, size / 16)) & ~1;
+    // The sweep is skipped if aggressive deflation alone did enough
+    if (m > 2) {
+      int found = AggressiveDeflation(H, lo, hi, m + m / 2, values);
+      if (found > 0)
+        deflate(found);
+      if (found * 100 > 14 * (m + m / 2))
+        continue;
+      size = hi - lo;
+      if (size < kMultishift)
+        m = 2;
+    }
+    // Every tenth step without deflation takes an exceptional double shift
+    // to break cycles
+    if (since % 10 == 9) {
+      double w = std::abs(H[{hi - 2, hi - 1}]) + std::abs(H[{hi - 3, hi - 2}]);
+      double h = H[{hi - 1, hi - 1}] + 0.75 * w;
+      FrancisStep(H, lo, hi, 2 * h, h * h + 0.4375 * w * w, Q);
+      m = 2;
+      if (observer)
+        notify(EigenEvent::Kind::Exceptional, lo, hi,
+               Roots(2 * h, h * h + 0.4375 * w * w));
+    } else if (m == 2) {
+      // The eigenvalues of the trailing 2 x 2 block
+      double a = H[{hi - 2, hi - 2}];
+      double b = H[{hi - 1, hi - 2}];
+      double c = H[{hi - 2, hi - 1}];
+      double d = H[{hi - 1, hi - 1}];
+      FrancisStep(H, lo, hi, a + d, a * d - b * c, Q);
+      if (observer)
+        notify(EigenEvent::Kind::Step, lo, hi, Roots(a + d, a * d - b * c));
+    } else {
+      auto shifts = Shifts(H, hi, m);
+      MultishiftSweep(H, lo, hi, shifts, workers);
+      if (observer)
+        notify(EigenEvent::Kind::Sweep, lo, hi, std::move(shifts));
+    }
+    ++iteration;
+    ++since;
+    if (report) {
+      ++report->iterations;
+      report->shifts += m;
+    }
+  }
+}
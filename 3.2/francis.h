@@ -0,0 +1,43 @@
+#pragma once
+#include <complex>
+#include <vector>
+
+#include "matrix.h"
+#include "solver.h"
+
+namespace Solver {
+// Implicit double-shift QR step of Francis on rows and columns lo .. hi - 1
+// of a Hessenberg matrix, hi - lo >= 3. The shifts are the roots of
+// x^2 - sum x + product, so a complex pair costs only real arithmetic. A
+// 3 x 3 bulge is chased down by reflectors of length three, each touching
+// two rows and two columns of the window. With Q the whole of H is updated
+// and the reflectors are accumulated into Q from the right.
+void FrancisStep(Matrix &H, int lo, int hi, double sum, double product,
+                 Matrix *Q = nullptr);
+
+// Small-bulge multishift sweep: a chain of double-shift bulges, one per
+// pair of shifts, is chased down the window three rows apart. Real shifts
+// are paired in the order given, complex ones must come with their
+// conjugates next to them. The reflectors are applied inside a diagonal
+// block around the chain and accumulated in an orthogonal matrix, which
+// updates the rest of the window by matrix products shared among the
+// workers.
+void MultishiftSweep(Matrix &H, int lo, int hi,
+                     const std::vector<std::complex<double>> &shifts,
+                     int workers = 1);
+
+// Aggressive early deflation: the trailing nw x nw block of the window is
+// brought to real Schur form and the blocks at its bottom whose share of
+// the spike H(hi - nw, hi - nw - 1) is negligible are split off. Their
+// eigenvalues go to values, the rest of the block is returned to
+// Hessenberg form. Returns the number of eigenvalues split off.
+int AggressiveDeflation(Matrix &H, int lo, int hi, int nw,
+                        std::vector<std::complex<double>> &values);
+
+// Eigenvalues of rows and columns lo .. hi - 1 of a Hessenberg matrix into
+// the same places of values. Only the active window is updated unless Q
+// is given, then H tends to the real Schur form Q^T H Q.
+void Schur(Matrix &H, int lo, int hi, std::vector<std::complex<double>> &values,
+           EigenReport *report = nullptr, int workers = 1,
+           Matrix *Q = nullptr);
+} // namespace Solver
@@ -0,0 +1,426 @@
+#include "hessenberg.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+#include "parallel.h"
+#include "solver.h"
+
+// Scratch of Reduce in doubles: V, Y, Vt, T, w, z, v and the block W of
+// every worker
+int ReductionSize(int n, int nb, int workers) {
+  return 3 * n * nb + nb * nb + 2 * nb + n +
+         workers * nb * ((n + workers - 1) / workers);
+}
+
+// ReduceHessenberg with panels of nb columns on scratch of ReductionSize
+void Reduce(Matrix &A, std::vector<double> &tau, int nb, int workers,
+            double *scratch) {
+  int n = A.rows();
+  // V and Y = A V T are n x nb by rows, Vt is V transposed, T is nb x nb
+  double *V = scratch;
+  double *Y = V + n * nb;
+  double *Vt = Y + n * nb;
+  double *T = Vt + nb * n;
+  double *w = T + nb * nb;
+  double *z = w + nb;
+  double *v = z + nb;
+  double *blocks = v + n;
+  auto row = [&A](int r) { return &A[{0, r}]; };
+
+  for (int k0 = 0; k0 < n - 2; k0 += nb) {
+    int k1 = std::min(k0 + nb, n - 2);
+    int b = k1 - k0;
+    std::fill(V, V + n * nb, 0.0);
+    std::fill(T, T + nb * nb, 0.0);
+
+    for (int p = 0; p < b; ++p) {
+      int j = k0 + p;
+      // Column j gets the reflectors of the panel from the right ...
+      for (int r = 0; r < n; ++r) {
+        double s = 0;
+        for (int q = 0; q < p; ++q)
+          s += Y[r * nb + q] * V[j * nb + q];
+        row(r)[j] -= s;
+      }
+      // ... and from the left: a_j -= V T^T V^T a_j
+      for (int q = 0; q < p; ++q) {
+        double s = 0;
+        for (int r = k0 + 1; r < n; ++r)
+          s += V[r * nb + q] * row(r)[j];
+        w[q] = s;
+      }
+      for (int q = p - 1; q >= 0; --q) {
+        double s = 0;
+        for (int t = 0; t <= q; ++t)
+          s += T[t * nb + q] * w[t];
+        w[q] = s;
+      }
+      for (int r = k0 + 1; r < n; ++r) {
+        double s = 0;
+        for (int q = 0; q < p; ++q)
+          s += V[r * nb + q] * w[q];
+        row(r)[j] -= s;
+      }
+
+      // Reflector that zeroes a_j below row j + 1
+      double x = row(j + 1)[j];
+      double sigma = 0;
+      for (int r = j + 2; r < n; ++r)
+        sigma += row(r)[j] * row(r)[j];
+      double t = 0;
+      std::fill(v, v + n, 0.0);
+      v[j + 1] = 1;
+      if (sigma > 0) {
+        double beta = -std::copysign(sqrt(x * x + sigma), x);
+        double scale = 1 / (x - beta);
+        for (int r = j + 2; r < n; ++r) {
+          row(r)[j] *= scale;
+          v[r] = row(r)[j];
+        }
+        row(j + 1)[j] = beta;
+        t = (beta - x) / beta;
+      }
+      tau[j] = t;
+      for (int r = j + 1; r < n; ++r)
+        V[r * nb + p] = v[r];
+
+      // T(0:p, p) = -t T(0:p, 0:p) V^T v
+      for (int q = 0; q < p; ++q) {
+        double s = 0;
+        for (int r = j + 1; r < n; ++r)
+          s += V[r * nb + q] * v[r];
+        z[q] = s;
+      }
+      for (int q = 0; q < p; ++q) {
+        double s = 0;
+        for (int u = q; u < p; ++u)
+          s += T[q * nb + u] * z[u];
+        T[q * nb + p] = -t * s;
+      }
+      T[p * nb + p] = t;
+
+      // Y(:, p) = t (A v - Y(:, 0:p) V^T v), columns after j are untouched
+      // since the start of the panel
+      Parallel(workers, [&](int worker) {
+        int first, last;
+        Share(worker, workers, 0, n, first, last);
+        for (int r = first; r < last; ++r) {
+          const double *a = row(r);
+          double s = 0;
+          for (int c = j + 1; c < n; ++c)
+            s += a[c] * v[c];
+          for (int q = 0; q < p; ++q)
+            s -= Y[r * nb + q] * z[q];
+          Y[r * nb + p] = t * s;
+        }
+      });
+    }
+
+    for (int r = 0; r < n; ++r)
+      for (int q = 0; q < b; ++q)
+        Vt[q * n + r] = V[r * nb + q];
+    // A Q for the columns after the panel: A -= Y V^T, by rows
+    Parallel(workers, [&](int worker) {
+      int first, last;
+      Share(worker, workers, 0, n, first, last);
+      for (int r = first; r < last; ++r) {
+        double *a = row(r);
+        for (int q = 0; q < b; ++q) {
+          const double y = Y[r * nb + q];
+          const double *vt = &Vt[q * n];
+          for (int c = k1; c < n; ++c)
+            a[c] -= y * vt[c];
+        }
+      }
+    });
+    // Q^T A for the same columns: C -= V T^T V^T C, by columns
+    Parallel(workers, [&](int worker) {
+      int first, last;
+      Share(worker, workers, k1, n, first, last);
+      if (first >= last)
+        return;
+      int width = last - first;
+      double *W = blocks + worker * nb * ((n + workers - 1) / workers);
+      std::fill(W, W + b * width, 0.0);
+      for (int r = k0 + 1; r < n; ++r) {
+        const double *a = row(r) + first;
+        for (int q = 0; q < b; ++q) {
+          const double vq = V[r * nb + q];
+          double *wq = &W[q * width];
+          for (int c = 0; c < width; ++c)
+            wq[c] += vq * a[c];
+        }
+      }
+      for (int q = b - 1; q >= 0; --q) {
+        double *wq = &W[q * width];
+        for (int c = 0; c < width; ++c)
+          wq[c] *= T[q * nb + q];
+        for (int s = 0; s < q; ++s) {
+          const double ts = T[s * nb + q];
+          const double *ws = &W[s * width];
+          for (int c = 0; c < width; ++c)
+            wq[c] += ts * ws[c];
+        }
+      }
+      for (int r = k0 + 1; r < n; ++r) {
+        double *a = row(r) + first;
+        for (int q = 0; q < b; ++q) {
+          const double vq = V[r * nb + q];
+          const double *wq = &W[q * width];
+          for (int c = 0; c < width; ++c)
+            a[c] -= vq * wq[c];
+        }
+      }
+    });
+  }
+}
+
+void Solver::ReduceHessenberg(Matrix &A, std::vector<double> &tau, int block,
+                              int workers) {
+  int n = A.rows();
+  if (A.cols() != n)
+    throw std::domain_error("Solver error # 2");
+  if (block < 1 || workers < 1)
+    throw std::domain_error("Solver error # 3");
+  tau.assign(n, 0.0);
+  if (n < 3)
+    return;
+  int nb = std::min(block, n - 2);
+  std::vector<double> scratch(ReductionSize(n, nb, workers));
+  Reduce(A, tau, nb, workers, scratch.data());
+}
+
+// Zeroes A below the subdiagonal
+void ClearReflectors(Matrix &A) {
+  int n = A.rows();
+  for (int r = 2; r < n; ++r)
+    for (int c = 0; c < r - 1; ++c)
+      A[{c, r}] = 0.0;
+}
+
+void Solver::Hessenberg(Matrix &A, int workers) {
+  std::vector<double> tau;
+  ReduceHessenberg(A, tau, 32, workers);
+  ClearReflectors(A);
+}
+
+void Solver::Hessenberg(Matrix &A, Workspace &workspace) {
+  int n = A.rows();
+  if (A.cols() != n)
+    throw std::domain_error("Solver error # 2");
+  if (n > workspace.size())
+    throw std::range_error("Workspace error # 2");
+  std::vector<double> &tau = workspace.tau();
+  tau.assign(n, 0.0);
+  if (n < 3)
+    return;
+  int nb = std::min(Workspace::kPanel, n - 2);
+  Reduce(A, tau, nb, 1, workspace.panel(ReductionSize(n, nb, 1)));
+  ClearReflectors(A);
+}
+
+// Frobenius norm of the window of a Hessenberg matrix
+double WindowNorm(const Matrix &H, int lo, int hi) {
+  double norm = 0;
+  for (int r = lo; r < hi; ++r)
+    for (int c = std::max(lo, r - 1); c < hi; ++c)
+      norm += H[{c, r}] * H[{c, r}];
+  return sqrt(norm);
+}
+
+void Shift(Matrix &H, int lo, int hi, double shift) {
+  for (int i = lo; i < hi; ++i)
+    H[{i, i}] -= shift;
+}
+
+bool Solver::LRStep(Matrix &H) { return LRStep(H, 0, H.rows(), 0); }
+
+bool Solver::LRStep(Matrix &H, int lo, int hi, double shift) {
+  double norm = WindowNorm(H, lo, hi);
+  Shift(H, lo, hi, shift);
+  for (int i = lo + 1; i < hi; ++i) {
+    double pivot = H[{i - 1, i - 1}];
+    // Multipliers above one would need pivoting, with shifts their growth
+    // costs digits of the eigenvalues
+    if (std::abs(pivot) <= 1e-14 * norm ||
+        std::abs(H[{i - 1, i}]) > std::abs(pivot)) {
+      // Back to H, the eliminations are undone in reverse order
+      for (int k = i - 1; k > lo; --k) {
+        double l = H[{k - 1, k}];
+        H[{k - 1, k}] = 0;
+        double *upper = &H[{0, k - 1}];
+        double *lower = &H[{0, k}];
+        for (int c = k; c < hi; ++c)
+          lower[c] += l * upper[c];
+        lower[k - 1] = l * upper[k - 1];
+      }
+      Shift(H, lo, hi, -shift);
+      return false;
+    }
+    double l = H[{i - 1, i}] / pivot;
+    double *upper = &H[{0, i - 1}];
+    double *lower = &H[{0, i}];
+    for (int c = i; c < hi; ++c)
+      lower[c] -= l * upper[c];
+    lower[i - 1] = l;
+  }
+  // R L: column i - 1 += l_i column i, in order of i
+  for (int i = lo + 1; i < hi; ++i) {
+    double l = H[{i - 1, i}];
+    H[{i - 1, i}] = 0;
+    for (int r = lo; r <= i; ++r)
+      H[{i - 1, r}] += l * H[{i, r}];
+  }
+  Shift(H, lo, hi, -shift);
+  return true;
+}
+
+void Solver::QRStep(Matrix &H) { QRStep(H, 0, H.rows(), 0); }
+
+void Solver::QRStep(Matrix &H, int lo, int hi, double shift) {
+  Shift(H, lo, hi, shift);
+  double c_prev = 1;
+  double s_prev = 0;
+  for (int i = lo + 1; i <= hi; ++i) {
+    double c = 1;
+    double s = 0;
+    if (i < hi) {
+      // G_i zeroes H(i, i - 1) against H(i - 1, i - 1)
+      double a = H[{i - 1, i - 1}];
+      double b = H[{i - 1, i}];
+      double r = std::hypot(a, b);
+      if (r > 0) {
+        c = a / r;
+        s = b / r;
+      }
+      Rotate(&H[{i - 1, i - 1}], &H[{i - 1, i}], hi - i + 1, c, -s);
+      H[{i - 1, i}] = 0;
+    }
+    // G_(i-1)^T from the right on columns i - 2 and i - 1
+    if (i >= lo + 2)
+      for (int r = lo; r < i; ++r) {
+        double x = H[{i - 2, r}];
+        double y = H[{i - 1, r}];
+        H[{i - 2, r}] = c_prev * x + s_prev * y;
+        H[{i - 1, r}] = -s_prev * x + c_prev * y;
+      }
+    c_prev = c;
+    s_prev = s;
+  }
+  Shift(H, lo, hi, -shift);
+}
+
+void Solver::InverseIteration(const Matrix &H,
+                              const std::vector<std::complex<double>> &values,
+                              Matrix &vectors, int workers) {
+  using Complex = std::complex<double>;
+  int n = H.rows();
+  int k = values.size();
+  if (n == 0 || H.cols() != n || vectors.rows() != n || vectors.cols() != k)
+    throw std::domain_error("Solver error # 2");
+  if (workers < 1)
+    throw std::domain_error("Solver error # 3");
+  // A real value or a pair is one job, its shift is moved off the shift of
+  // the job before when they are too close to give different vectors
+  const double eps = std::numeric_limits<double>::epsilon();
+  double norm = std::numeric_limits<double>::min();
+  for (int r = 0; r < n; ++r) {
+    double sum = 0;
+    for (int c = std::max(r - 1, 0); c < n; ++c)
+      sum += std::abs(H[{c, r}]);
+    norm = std::max(norm, sum);
+  }
+  const double tiny = eps * norm;
+  const double tolerance = 10 * n * eps * norm;
+  std::vector<int> jobs;
+  std::vector<Complex> shifts;
+  for (int j = 0; j < k; ++j) {
+    Complex shift = values[j];
+    if (!shifts.empty() && std::abs(shift - shifts.back()) < 10 * tiny)
+      shift = shifts.back() + 10 * tiny;
+    jobs.push_back(j);
+    shifts.push_back(shift);
+    if (values[j].imag() != 0) {
+      if (values[j].imag() < 0 || j + 1 == k ||
+          values[j + 1] != std::conj(values[j]))
+        throw std::domain_error("Solver error # 3");
+      ++j;
+    }
+  }
+
+  Parallel(workers, [&](int w) {
+    int first, last;
+    Share(w, workers, 0, static_cast<int>(jobs.size()), first, last);
+    std::vector<Complex> LU(first < last ? static_cast<size_t>(n) * n : 0);
+    std::vector<Complex> multiplier(n), x(n);
+    std::vector<char> swapped(n);
+    for (int job = first; job < last; ++job) {
+      int j = jobs[job];
+      for (int r = 0; r < n; ++r)
+        for (int c = std::max(r - 1, 0); c < n; ++c)
+          LU[r * n + c] = H[{c, r}] - (r == c ? shifts[job] : 0.0);
+      for (int i = 0; i + 1 < n; ++i) {
+        Complex *p = &LU[i * n];
+        Complex *q = p + n;
+        swapped[i] = std::abs(q[i]) > std::abs(p[i]);
+        if (swapped[i])
+          std::swap_ranges(p + i, p + n, q + i);
+        if (std::abs(p[i]) < tiny)
+          p[i] = tiny;
+        multiplier[i] = q[i] / p[i];
+        for (int c = i + 1; c < n; ++c)
+          q[c] -= multiplier[i] * p[c];
+      }
+      if (std::abs(LU[n * n - 1]) < tiny)
+        LU[n * n - 1] = tiny;
+
+      auto length = [&x]() {
+        double sum = 0;
+        for (const Complex &v : x)
+          sum += std::norm(v);
+        return std::sqrt(sum);
+      };
+      std::mt19937 gen(j + 1);
+      std::uniform_real_distribution<double> dist(-1, 1);
+      for (Complex &v : x)
+        v = dist(gen);
+      for (int iteration = 0; iteration < 5; ++iteration) {
+        double scale = 1 / length();
+        for (Complex &v : x)
+          v *= scale;
+        for (int i = 0; i + 1 < n; ++i) {
+          if (swapped[i])
+            std::swap(x[i], x[i + 1]);
+          x[i + 1] -= multiplier[i] * x[i];
+        }
+        for (int r = n - 1; r >= 0; --r) {
+          Complex s = x[r];
+          for (int c = r + 1; c < n; ++c)
+            s -= LU[r * n + c] * x[c];
+          x[r] = s / LU[r * n + r];
+        }
+        // |x| was 1, so the residual of x / growth is 1 / growth
+        double growth = length();
+        for (Complex &v : x)
+          v /= growth;
+        if (1 / growth <= tolerance)
+          break;
+      }
+      // Unit length, the largest component real and positive
+      int largest = 0;
+      for (int r = 1; r < n; ++r)
+        if (std::abs(x[r]) > std::abs(x[largest]))
+          largest = r;
+      Complex phase = std::conj(x[largest]) / std::abs(x[largest]) / length();
+      for (int r = 0; r < n; ++r) {
+        Complex v = x[r] * phase;
+        vectors[{j, r}] = v.real();
+        if (values[j].imag() != 0)
+          vectors[{j + 1, r}] = v.imag();
+      }
+    }
+  });
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <complex>
+#include <vector>
+
+#include "matrix.h"
+#include "solver.h"
+
+namespace Solver {
+// H = Q^T A Q in upper Hessenberg form, Q = H_0 ... H_(n-3) with
+// H_j = I - tau_j v_j v_j^T. Reflectors are built in panels of `block`
+// columns; A V T of the panel is accumulated on the fly, so the rest of the
+// matrix is updated once per panel by matrix products shared among the
+// workers. The vectors v_j are left below the subdiagonal, v_j(j + 1) = 1.
+void ReduceHessenberg(Matrix &A, std::vector<double> &tau, int block = 32,
+                      int workers = 1);
+// The same with the reflectors cleared, for the eigenvalue iterations
+void Hessenberg(Matrix &A, int workers = 1);
+// The same on the storage of the workspace, one worker, allocates nothing
+void Hessenberg(Matrix &A, Workspace &workspace);
+
+// One step H = R L of the LR algorithm on a Hessenberg matrix, in place and
+// in O(n^2): the multipliers of H = L R are kept where they zero H, and the
+// product R L is formed by column operations. Returns false and leaves H as
+// it was if elimination would need pivoting: a pivot is negligible or
+// smaller in modulus than the entry it eliminates.
+bool LRStep(Matrix &H);
+// The step on H - shift I restricted to rows and columns lo .. hi - 1, the
+// shift is added back afterwards. The rest of H is not updated, which is
+// enough for eigenvalues once the window is split off by a zero subdiagonal.
+bool LRStep(Matrix &H, int lo, int hi, double shift);
+// One step H = R Q by Givens rotations, the same cost, always defined. The
+// rotations from the left and from the right run one column apart, so no
+// rotation has to be stored.
+void QRStep(Matrix &H);
+void QRStep(Matrix &H, int lo, int hi, double shift);
+
+// Eigenvectors of a Hessenberg matrix for values in the order EigenValues
+// gives them, by inverse iteration into the columns of vectors
+// (n x values.size()). Only H on and above the subdiagonal is read, so the
+// reflectors of ReduceHessenberg may stay below it. A real value gives its
+// unit vector, a pair a + bi, a - bi the real and imaginary parts of the
+// unit vector of a + bi. H - value I is factored once per value in O(n^2),
+// pivoting only between adjacent rows; the values are shared among the
+// workers.
+void InverseIteration(const Matrix &H,
+                      const std::vector<std::complex<double>> &values,
+                      Matrix &vectors, int workers = 1);
+} // namespace Solver
@@ -0,0 +1,373 @@
+#include "krylov.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "francis.h"
+#include "solver.h"
+#include "tridiagonal.h"
+
+using Complex = std::complex<double>;
+
+// Restarts before the iterations are reported as divergent
+constexpr int kRestarts = 1000;
+
+// Krylov factorization A V = V H + beta v_m e_m^T: columns 0 .. m of V are
+// the orthonormal basis, n apart, H is m x m Hessenberg (tridiagonal for a
+// symmetric A)
+struct Krylov {
+  Krylov(const Solver::Operator &A, int n, int m, bool symmetric)
+      : A(A), n(n), m(m), symmetric(symmetric),
+        V(static_cast<size_t>(m + 1) * n), H(m, m) {}
+
+  double *v(int j) { return V.data() + static_cast<size_t>(j) * n; }
+
+  const Solver::Operator &A;
+  int n;
+  int m;
+  bool symmetric;
+  std::vector<double> V;
+  Matrix H;
+  double beta = 0;
+  std::mt19937 random{1};
+};
+
+double Dot(const double *x, const double *y, int n) {
+  double sum = 0;
+  for (int i = 0; i < n; ++i)
+    sum += x[i] * y[i];
+  return sum;
+}
+
+// Orthogonalizes column j of V against the columns before it, in two passes
+// as one loses orthogonality, and normalizes it. The coefficients are added
+// to h when given. Returns the norm taken off; a column in the span of the
+// others is replaced by a random direction and 0 is returned.
+double Orthonormalize(Krylov &K, int j, double *h) {
+  int n = K.n;
+  double *w = K.v(j);
+  bool random = false;
+  while (true) {
+    double before = std::sqrt(Dot(w, w, n));
+    for (int pass = 0; pass < 2; ++pass)
+      for (int i = 0; i < j; ++i) {
+        const double *q = K.v(i);
+        double c = Dot(q, w, n);
+        for (int r = 0; r < n; ++r)
+          w[r] -= c * q[r];
+        if (h && !random)
+          h[i] += c;
+      }
+    double norm = std::sqrt(Dot(w, w, n));
+    if (norm > 1e-12 * before) {
+      for (int r = 0; r < n; ++r)
+        w[r] /= norm;
+      return random ? 0 : norm;
+    }
+    if (j >= n) {
+      std::fill(w, w + n, 0.0);
+      return 0;
+    }
+    std::uniform_real_distribution<double> dist(-1, 1);
+    for (int r = 0; r < n; ++r)
+      w[r] = dist(K.random);
+    random = true;
+  }
+}
+
+// Steps from .. m - 1 of the Arnoldi (Lanczos) process, v_from is given
+void Expand(Krylov &K, int from) {
+  std::vector<double> h(K.m);
+  for (int j = from; j < K.m; ++j) {
+    K.A(K.v(j), K.v(j + 1));
+    std::fill(h.begin(), h.end(), 0.0);
+    double beta = Orthonormalize(K, j + 1, h.data());
+    for (int i = 0; i < K.m; ++i)
+      K.H[{j, i}] = 0;
+    if (K.symmetric) {
+      K.H[{j, j}] = h[j];
+      if (j > 0)
+        K.H[{j, j - 1}] = K.H[{j - 1, j}];
+    } else {
+      for (int i = 0; i <= j; ++i)
+        K.H[{j, i}] = h[i];
+    }
+    if (j + 1 < K.m)
+      K.H[{j, j + 1}] = beta;
+    K.beta = beta;
+  }
+}
+
+// |y_m| / |y| for the eigenvector y of the Hessenberg H with the value
+// theta, by two steps of inverse iteration with H - theta I factored once
+double LastComponent(const Matrix &H, Complex theta) {
+  int m = H.rows();
+  double norm = std::abs(theta);
+  for (int r = 0; r < m; ++r)
+    for (int c = 0; c < m; ++c)
+      norm = std::max(norm, std::abs(H[{c, r}]));
+  double tiny = std::numeric_limits<double>::epsilon() *
+                std::max(norm, std::numeric_limits<double>::min());
+  std::vector<Complex> LU(m * m);
+  for (int r = 0; r < m; ++r)
+    for (int c = 0; c < m; ++c)
+      LU[r * m + c] = H[{c, r}] - (r == c ? theta : 0.0);
+  // Partial pivoting only swaps adjacent rows of a Hessenberg matrix
+  std::vector<Complex> multiplier(m);
+  std::vector<char> swapped(m);
+  for (int k = 0; k + 1 < m; ++k) {
+    Complex *p = &LU[k * m];
+    Complex *q = p + m;
+    swapped[k] = std::abs(q[k]) > std::abs(p[k]);
+    if (swapped[k])
+      std::swap_ranges(p + k, p + m, q + k);
+    if (std::abs(p[k]) < tiny)
+      p[k] = tiny;
+    multiplier[k] = q[k] / p[k];
+    for (int c = k; c < m; ++c)
+      q[c] -= multiplier[k] * p[c];
+  }
+  if (std::abs(LU[m * m - 1]) < tiny)
+    LU[m * m - 1] = tiny;
+
+  std::vector<Complex> y(m, 1.0);
+  for (int step = 0; step < 2; ++step) {
+    for (int k = 0; k + 1 < m; ++k) {
+      if (swapped[k])
+        std::swap(y[k], y[k + 1]);
+      y[k + 1] -= multiplier[k] * y[k];
+    }
+    for (int r = m - 1; r >= 0; --r) {
+      Complex s = y[r];
+      for (int c = r + 1; c < m; ++c)
+        s -= LU[r * m + c] * y[c];
+      y[r] = s / LU[r * m + r];
+    }
+    double scale = 0;
+    for (const Complex &x : y)
+      scale = std::max(scale, std::abs(x));
+    for (Complex &x : y)
+      x /= scale;
+  }
+  double sum = 0;
+  for (const Complex &x : y)
+    sum += std::norm(x);
+  return std::abs(y[m - 1]) / std::sqrt(sum);
+}
+
+// Ritz values of the factorization, the most wanted first, with the
+// estimates beta |y_m| of their residuals
+void Ritz(Krylov &K, Solver::Extreme which, std::vector<Complex> &values,
+          std::vector<double> &residuals) {
+  int m = K.m;
+  values.assign(m, 0.0);
+  residuals.assign(m, 0.0);
+  if (K.symmetric) {
+    std::vector<double> d(m), e(std::max(m - 1, 0));
+    for (int i = 0; i < m; ++i)
+      d[i] = K.H[{i, i}];
+    for (int i = 0; i + 1 < m; ++i)
+      e[i] = K.H[{i, i + 1}];
+    Matrix Z(m, m);
+    Solver::DivideConquer(d, e, &Z);
+    for (int i = 0; i < m; ++i) {
+      values[i] = d[i];
+      residuals[i] = std::abs(K.beta * Z[{i, m - 1}]);
+    }
+  } else {
+    Matrix T = K.H;
+    Solver::Schur(T, 0, m, values);
+    for (int i = 0; i < m; ++i)
+      residuals[i] = std::abs(K.beta) * LastComponent(K.H, values[i]);
+  }
+
+  auto key = [which](const Complex &x) {
+    if (which == Solver::Extreme::Magnitude)
+      return std::abs(x);
+    return which == Solver::Extreme::Largest ? x.real() : -x.real();
+  };
+  std::vector<int> order(m);
+  std::iota(order.begin(), order.end(), 0);
+  // A conjugate pair stays together, the positive imaginary part first
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    double ka = key(values[a]);
+    double kb = key(values[b]);
+    if (ka != kb)
+      return ka > kb;
+    double ia = std::abs(values[a].imag());
+    double ib = std::abs(values[b].imag());
+    if (ia != ib)
+      return ia > ib;
+    return values[a].imag() > values[b].imag();
+  });
+  std::vector<Complex> sortedValues(m);
+  std::vector<double> sortedResiduals(m);
+  for (int i = 0; i < m; ++i) {
+    sortedValues[i] = values[order[i]];
+    sortedResiduals[i] = residuals[order[i]];
+  }
+  values.swap(sortedValues);
+  residuals.swap(sortedResiduals);
+}
+
+// QR step with the real shift mu on the Hessenberg H: H - mu I = Q R by
+// rotations, H = R Q + mu I, the rotations are accumulated into U
+void RealShift(Matrix &H, double mu, Matrix &U) {
+  int m = H.rows();
+  std::vector<double> cos(m), sin(m);
+  for (int i = 0; i < m; ++i)
+    H[{i, i}] -= mu;
+  for (int i = 0; i + 1 < m; ++i) {
+    double a = H[{i, i}];
+    double b = H[{i, i + 1}];
+    double r = std::hypot(a, b);
+    cos[i] = r == 0 ? 1 : a / r;
+    sin[i] = r == 0 ? 0 : b / r;
+    Solver::Rotate(&H[{i, i}], &H[{i, i + 1}], m - i, cos[i], -sin[i]);
+  }
+  for (int i = 0; i + 1 < m; ++i) {
+    for (int r = 0; r <= i + 1; ++r) {
+      double x = H[{i, r}];
+      double y = H[{i + 1, r}];
+      H[{i, r}] = cos[i] * x + sin[i] * y;
+      H[{i + 1, r}] = cos[i] * y - sin[i] * x;
+    }
+    for (int r = 0; r < m; ++r) {
+      double x = U[{i, r}];
+      double y = U[{i + 1, r}];
+      U[{i, r}] = cos[i] * x + sin[i] * y;
+      U[{i + 1, r}] = cos[i] * y - sin[i] * x;
+    }
+  }
+  for (int i = 0; i < m; ++i)
+    H[{i, i}] += mu;
+}
+
+// Implicit restart: the shifts are applied to H by QR steps accumulated in
+// U, the basis becomes V U and is cut to k vectors plus the new residual.
+// The start vector is thereby filtered by the polynomial vanishing at the
+// shifts without a single product by A.
+void Restart(Krylov &K, int k, const std::vector<Complex> &shifts) {
+  int m = K.m;
+  int n = K.n;
+  Matrix U(m, [](int c, int r) { return c == r ? 1.0 : 0.0; });
+  for (const Complex &mu : shifts) {
+    if (mu.imag() == 0)
+      RealShift(K.H, mu.real(), U);
+    else if (mu.imag() > 0)
+      Solver::FrancisStep(K.H, 0, m, 2 * mu.real(), std::norm(mu), &U);
+  }
+  if (K.symmetric) {
+    for (int r = 0; r < m; ++r) {
+      for (int c = 0; c < m; ++c) {
+        if (c > r + 1 || r > c + 1)
+          K.H[{c, r}] = 0;
+        else if (r == c + 1)
+          K.H[{c, r}] = K.H[{r, c}] = (K.H[{c, r}] + K.H[{r, c}]) / 2;
+      }
+    }
+  }
+
+  double beta = K.H[{k - 1, k}];
+  double sigma = U[{k - 1, m - 1}];
+  std::vector<double> row(k + 1);
+  for (int r = 0; r < n; ++r) {
+    for (int j = 0; j <= k; ++j) {
+      double s = 0;
+      for (int l = 0; l < m; ++l)
+        s += K.V[static_cast<size_t>(l) * n + r] * U[{j, l}];
+      row[j] = s;
+    }
+    for (int j = 0; j <= k; ++j)
+      K.V[static_cast<size_t>(j) * n + r] = row[j];
+  }
+  double *f = K.v(k);
+  const double *last = K.v(m);
+  for (int r = 0; r < n; ++r)
+    f[r] = beta * f[r] + K.beta * sigma * last[r];
+  K.H[{k - 1, k}] = Orthonormalize(K, k, nullptr);
+}
+
+void Restarted(Krylov &K, int k, Solver::Extreme which, double tolerance,
+               std::vector<Complex> &values, std::vector<double> &residuals) {
+  const double eps = std::numeric_limits<double>::epsilon();
+  int m = K.m;
+  std::uniform_real_distribution<double> dist(-1, 1);
+  double *start = K.v(0);
+  for (int r = 0; r < K.n; ++r)
+    start[r] = dist(K.random);
+  Orthonormalize(K, 0, nullptr);
+  Expand(K, 0);
+
+  for (int restart = 0;; ++restart) {
+    Ritz(K, which, values, residuals);
+    double largest = 0;
+    for (const Complex &x : values)
+      largest = std::max(largest, std::abs(x));
+    int converged = 0;
+    for (int i = 0; i < k; ++i)
+      converged += residuals[i] <=
+                   tolerance * std::max(std::abs(values[i]), eps * largest);
+    if (converged == k) {
+      values.resize(k);
+      residuals.resize(k);
+      return;
+    }
+    if (restart == kRestarts)
+      throw std::runtime_error("Solver error # 4");
+
+    // Keeping some converged values beyond k speeds up the rest; a pair
+    // is not split between the kept and the shifts
+    int kept = std::min(k + std::min(converged, (m - k) / 2), m - 1);
+    if (values[kept].imag() != 0 && values[kept] == std::conj(values[kept - 1]))
+      kept += kept + 1 < m ? 1 : -1;
+    Restart(K, kept, std::vector<Complex>(values.begin() + kept, values.end()));
+    Expand(K, kept);
+  }
+}
+
+void Check(int n, int k, double tolerance) {
+  if (n < 1)
+    throw std::domain_error("Solver error # 2");
+  if (k < 1 || k > n || !(tolerance > 0))
+    throw std::domain_error("Solver error # 3");
+}
+
+Solver::Operator Solver::Product(const Matrix &A) {
+  if (A.rows() != A.cols())
+    throw std::domain_error("Solver error # 2");
+  return [&A](const double *x, double *y) {
+    int n = A.rows();
+    for (int r = 0; r < n; ++r) {
+      double sum = 0;
+      for (int c = 0; c < n; ++c)
+        sum += A[{c, r}] * x[c];
+      y[r] = sum;
+    }
+  };
+}
+
+void Solver::Lanczos(int n, int k, const Operator &A,
+                     std::vector<double> &values,
+                     std::vector<double> &residuals, Extreme which,
+                     double tolerance) {
+  Check(n, k, tolerance);
+  Krylov K(A, n, std::min(n, 2 * k + 8), true);
+  std::vector<Complex> ritz;
+  Restarted(K, k, which, tolerance, ritz, residuals);
+  values.resize(k);
+  for (int i = 0; i < k; ++i)
+    values[i] = ritz[i].real();
+}
+
+void Solver::Arnoldi(int n, int k, const Operator &A,
+                     std::vector<std::complex<double>> &values,
+                     std::vector<double> &residuals, Extreme which,
+                     double tolerance) {
+  Check(n, k, tolerance);
+  Krylov K(A, n, std::min(n, 2 * k + 8), false);
+  Restarted(K, k, which, tolerance, values, residuals);
+}
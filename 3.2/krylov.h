@@ -0,0 +1,35 @@
+#pragma once
+#include <complex>
+#include <functional>
+#include <vector>
+
+#include "matrix.h"
+
+namespace Solver {
+// y = A x for vectors of length n, the only access to A the Krylov solvers
+// need, so A may be dense, sparse or generated by a formula
+using Operator = std::function<void(const double *x, double *y)>;
+// The product by a square matrix, which must outlive the operator
+Operator Product(const Matrix &A);
+
+// End of the spectrum wanted: the largest in modulus, the largest or the
+// smallest real parts
+enum class Extreme { Magnitude, Largest, Smallest };
+
+// The k eigenvalues of a symmetric operator of size n at the chosen end of
+// the spectrum, the most extreme first, by the Lanczos process restarted
+// implicitly with the unwanted Ritz values as shifts. A basis of
+// m = min(n, 2 k + 8) vectors is all that is kept, so the memory is O(n k).
+// residuals are the estimates of |A x - value x| for the unit Ritz vectors
+// x, the iterations stop when each of them is below tolerance |value|.
+void Lanczos(int n, int k, const Operator &A, std::vector<double> &values,
+             std::vector<double> &residuals, Extreme which = Extreme::Largest,
+             double tolerance = 1e-10);
+// The same for a general operator by the Arnoldi process, the shifts and
+// the values may be complex, a conjugate pair comes with the positive
+// imaginary part first
+void Arnoldi(int n, int k, const Operator &A,
+             std::vector<std::complex<double>> &values,
+             std::vector<double> &residuals,
+             Extreme which = Extreme::Magnitude, double tolerance = 1e-10);
+} // namespace Solver
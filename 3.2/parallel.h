@@ -0,0 +1,26 @@
+#pragma once
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+// Runs f(0) ... f(workers - 1) concurrently, f(0) on the calling thread
+template <class Func> void Parallel(int workers, Func f) {
+  if (workers < 1)
+    throw std::runtime_error("Parallel error # 1");
+  std::vector<std::future<void>> futures;
+  futures.reserve(workers - 1);
+  for (int w = 1; w < workers; ++w)
+    futures.push_back(std::async(std::launch::async, f, w));
+  f(0);
+  for (auto &future : futures)
+    future.get();
+}
+
+// Rows first .. last - 1 of the share of worker w in begin .. end - 1
+inline void Share(int w, int workers, int begin, int end, int &first,
+                  int &last) {
+  int step = (end - begin + workers - 1) / workers;
+  first = std::min(end, begin + w * step);
+  last = std::min(end, first + step);
+}
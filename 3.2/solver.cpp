@@ -1,48 +1,150 @@
 #include "solver.h"
+#include "francis.h"
+#include "hessenberg.h"
+#include "symmetric.h"
+#include "tridiagonal.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 #include <utility>
 
 constexpr double eps = 1e-10;
 
+Solver::Workspace::Workspace(int n) : _n(n) {
+  if (n < 1)
+    throw std::domain_error("Workspace error # 1");
+  _data.assign(2 * n * n + 3 * n, 0.0);
+  // Covers ReductionSize of the Hessenberg reduction, the largest of them
+  _panel.assign(4 * n * kPanel + kPanel * kPanel + 2 * kPanel + n, 0.0);
+  _tau.reserve(n);
+  _diagonal.reserve(n);
+  _offdiagonal.reserve(n + 1);
+  _values.reserve(n);
+}
+
+int Solver::Workspace::size() const { return _n; }
+
+Matrix Solver::Workspace::view(int offset, int cols, int rows) {
+  if (offset + cols * rows > static_cast<int>(_data.size()))
+    throw std::range_error("Workspace error # 2");
+  Matrix M(cols, rows, _data.data() + offset);
+  M.release();
+  return M;
+}
+
+Matrix Solver::Workspace::LR(int N) {
+  if (N > _n)
+    throw std::range_error("Workspace error # 2");
+  return view(0, N, N);
+}
+
+Matrix Solver::Workspace::product(int N) {
+  if (N > _n)
+    throw std::range_error("Workspace error # 2");
+  return view(_n * _n, N, N);
+}
+
+Matrix Solver::Workspace::row(int N) {
+  if (N > _n)
+    throw std::range_error("Workspace error # 2");
+  return view(2 * _n * _n, 3 * N, 1);
+}
+
+double *Solver::Workspace::panel(int size) {
+  if (size > static_cast<int>(_panel.size()))
+    throw std::range_error("Workspace error # 2");
+  return _panel.data();
+}
+
+std::vector<double> &Solver::Workspace::tau() { return _tau; }
+
+std::vector<double> &Solver::Workspace::diagonal() { return _diagonal; }
+
+std::vector<double> &Solver::Workspace::offdiagonal() { return _offdiagonal; }
+
+std::vector<std::complex<double>> &Solver::Workspace::values() {
+  return _values;
+}
+
 double length_hint(double x1, double x2, double &x1_sqr_len) {
   x1_sqr_len += x2 * x2;
   double len = sqrt(x1_sqr_len);
   return len;
 }
 
-void Solver::AlignRow(Matrix &col_A, const std::vector<Matrix *> &rest) {
+void Solver::Rotate(double *x, double *y, int n, double cos, double sin) {
+  for (int k = 0; k < n; ++k) {
+    double a = x[k];
+    double b = y[k];
+    x[k] = cos * a - sin * b;
+    y[k] = sin * a + cos * b;
+  }
+}
+
+void Solver::AlignRow(Matrix &col_A, const std::vector<Matrix *> &rest,
+                      Matrix *scratch) {
+  AlignRow(col_A, rest.data(), static_cast<int>(rest.size()), scratch);
+}
+
+void Solver::AlignRow(Matrix &col_A, Matrix *const *rest, int count,
+                      Matrix *scratch) {
   int N = col_A.rows();
   int i = 0;
-  while (abs(col_A[{0, i}]) < eps && i < N)
+  while (i < N && std::abs(col_A[{0, i}]) < eps)
     ++i;
   if (i == N)
     return; // throw std::runtime_error("Solver error # 1");
   col_A.swap(0, i, 'r');
-  for (auto *item : rest)
-    item->swap(i, 0, 'r');
+  for (int k = 0; k < count; ++k)
+    rest[k]->swap(i, 0, 'r');
+
+  // The whole sequence of rotations depends on the column only, so it is
+  // found first: (row, cos, sin) of every rotation
+  std::vector<double> local;
+  double *rotations;
+  if (scratch && scratch->cols() >= 3 * N) {
+    rotations = &(*scratch)[{0, 0}];
+  } else {
+    local.resize(3 * N);
+    rotations = local.data();
+  }
+  int rotated = 0;
   double &x1 = col_A[{0, 0}];
   double square_len = x1 * x1;
   for (int j = 1; j < N; ++j) {
     double &x2 = col_A[{0, j}];
-    if (abs(x2) < eps)
+    if (std::abs(x2) < eps)
       continue;
     double len = length_hint(x1, x2, square_len);
-    double cos = x1 / len;
-    double sin = -x2 / len;
+    rotations[3 * rotated] = j;
+    rotations[3 * rotated + 1] = x1 / len;
+    rotations[3 * rotated + 2] = -x2 / len;
+    ++rotated;
     x1 = len;
     x2 = 0;
-    for (auto *item : rest) {
-      auto row0 = std::move(item->row(0));
-      auto rowj = std::move(item->row(j));
-      auto init_row0 = row0;
-      (row0 *= cos).add_scaled(rowj, -sin);
-      (rowj *= cos).add_scaled(init_row0, sin);
+  }
+
+  // and then applied to tiles of columns, so the tile of row 0 stays in
+  // cache while every other row passes through it once
+  const int tile = 256;
+  for (int k = 0; k < count; ++k) {
+    Matrix *item = rest[k];
+    int M = item->cols();
+    double *row0 = &(*item)[{0, 0}];
+    for (int c0 = 0; c0 < M; c0 += tile) {
+      int len = std::min(tile, M - c0);
+      for (int r = 0; r < rotated; ++r) {
+        double *rowj = &(*item)[{0, static_cast<int>(rotations[3 * r])}];
+        Rotate(row0 + c0, rowj + c0, len, rotations[3 * r + 1],
+               rotations[3 * r + 2]);
+      }
     }
   }
 }
 
-void Solver::Align(Matrix &A, Matrix *B) {
+void Solver::Align(Matrix &A, Matrix *B, Matrix *scratch) {
   int N = A.rows();
   int M = A.cols();
   for (int i = 0; i < N - 1; ++i) {
@@ -50,28 +152,38 @@ void Solver::Align(Matrix &A, Matrix *B) {
     auto rest = std::move(A.submat({i + 1, i}, {M - 1, N - 1}));
     if (B) {
       auto subcol_B = std::move(B->submat({0, i}, {0, N - 1}));
-      AlignRow(subcol_A, {&rest, &subcol_B});
+      Matrix *both[] = {&rest, &subcol_B};
+      AlignRow(subcol_A, both, 2, scratch);
     } else {
-      AlignRow(subcol_A, {&rest});
+      Matrix *one[] = {&rest};
+      AlignRow(subcol_A, one, 1, scratch);
     }
   }
 }
 
-void Solver::QuasiTriangulate(Matrix &A, Matrix *B) {
+void Solver::QuasiTriangulate(Matrix &A, Matrix *B, Matrix *scratch) {
   int N = A.rows();
   auto trimA = std::move(A.submat({0, 1}, {N - 1, N - 1}));
   if (B) {
     auto trimB = std::move(B->submat({0, 1}, {0, N - 1}));
-    Solver::Align(trimA, &trimB);
+    Solver::Align(trimA, &trimB, scratch);
   } else {
-    Solver::Align(trimA);
+    Solver::Align(trimA, nullptr, scratch);
   }
 }
 
 Matrix Solver::DecomposeLR(Matrix &A) {
-  Solver::QuasiTriangulate(A);
+  Matrix LR = Matrix(A.rows());
+  DecomposeLR(A, LR);
+  return LR;
+}
+
+void Solver::DecomposeLR(Matrix &A, Matrix &LR, Matrix *scratch) {
+  Solver::QuasiTriangulate(A, nullptr, scratch);
   int N = A.rows();
-  Matrix LR = Matrix(N);
+  for (int j = 0; j < N; ++j)
+    for (int i = 0; i < N; ++i)
+      LR[{i, j}] = 0.0;
   for (int i = 0; i < N; ++i)
     LR[{i, 0}] = A[{i, 0}];
   for (int i = 1; i < N; ++i) {
@@ -80,27 +192,112 @@ Matrix Solver::DecomposeLR(Matrix &A) {
     for (int k = i; k < N; ++k)
       LR[{k, i}] = A[{k, i}] - l * LR[{k, i - 1}];
   }
+}
 
-  return LR;
+using Complex = std::complex<double>;
+
+// Symmetric matrices go to the tridiagonal path, the rest to the Hessenberg
+// reduction and the Schur iteration on it
+void Iterate(Matrix &A, std::vector<Complex> &values,
+             Solver::EigenReport *report) {
+  int N = A.rows();
+  if (report) {
+    report->iterations = report->shifts = 0;
+    report->steps.clear();
+  }
+  if (Solver::IsSymmetric(A)) {
+    auto real = Solver::SymmetricEigenValues(A);
+    values.assign(real.begin(), real.end());
+    return;
+  }
+  values.assign(N, 0.0);
+  int workers =
+      N < 256 ? 1 : std::max(1u, std::thread::hardware_concurrency());
+  Solver::Hessenberg(A, workers);
+  Solver::Schur(A, 0, N, values, report, workers);
+  std::sort(values.begin(), values.end(), [](Complex x, Complex y) {
+    return x.real() != y.real() ? x.real() > y.real() : x.imag() > y.imag();
+  });
 }
 
-std::vector<double> Solver::EigenValues(Matrix &A) {
+void Iterate(Matrix &A, std::vector<double> &values,
+             Solver::EigenReport *report) {
+  std::vector<Complex> all;
+  Iterate(A, all, report);
+  values.resize(all.size());
+  for (size_t i = 0; i < all.size(); ++i) {
+    if (all[i].imag() != 0)
+      throw std::runtime_error("Solver error # 5");
+    values[i] = all[i].real();
+  }
+}
+
+std::vector<double> Solver::EigenValues(Matrix &A, EigenReport *report) {
+  std::vector<double> values;
+  Iterate(A, values, report);
+  return values;
+}
+
+void Solver::EigenValues(Matrix &A, std::vector<Complex> &values,
+                         EigenReport *report) {
+  Iterate(A, values, report);
+}
+
+void Solver::EigenValues(Matrix &A, Workspace &workspace,
+                         std::vector<double> &values, EigenReport *report) {
   int N = A.rows();
-  std::vector<double> values(N);
-
-  auto LR = Solver::DecomposeLR(A);
-  double diff = 1;
-  while (diff > eps) {
-    diff = 0;
-    Matrix L(N, [&](int i, int j) { return i < j ? LR[{i, j}] : i == j; });
-    Matrix R(N, [&](int i, int j) { return i >= j ? LR[{i, j}] : 0.0; });
-    LR = R * L;
-    for (int i = 0; i < N; ++i) {
-      diff += std::abs(values[i] - LR[{i, i}]);
-      values[i] = LR[{i, i}];
+  if (A.cols() != N)
+    throw std::domain_error("Solver error # 2");
+  if (report) {
+    report->iterations = report->shifts = 0;
+    report->steps.clear();
+  }
+  if (IsSymmetric(A)) {
+    Tridiagonalize(A, workspace);
+    std::vector<double> &d = workspace.diagonal();
+    QLEigenValues(d, workspace.offdiagonal());
+    values.assign(d.rbegin(), d.rend());
+    return;
+  }
+  Hessenberg(A, workspace);
+  std::vector<Complex> &all = workspace.values();
+  all.assign(N, 0.0);
+  Schur(A, 0, N, all, report, 1);
+  values.resize(N);
+  for (int i = 0; i < N; ++i) {
+    if (all[i].imag() != 0)
+      throw std::runtime_error("Solver error # 5");
+    values[i] = all[i].real();
+  }
+  std::sort(values.begin(), values.end(), std::greater<double>());
+}
+
+void Solver::EigenVectors(const Matrix &A, const std::vector<Complex> &values,
+                          Matrix &vectors) {
+  int n = A.rows();
+  if (A.cols() != n)
+    throw std::domain_error("Solver error # 2");
+  int workers =
+      n < 256 ? 1 : std::max(1u, std::thread::hardware_concurrency());
+  Matrix B = A;
+  std::vector<double> tau;
+  if (IsSymmetric(A)) {
+    std::vector<double> d, e, real(values.size());
+    for (size_t i = 0; i < values.size(); ++i) {
+      if (values[i].imag() != 0)
+        throw std::runtime_error("Solver error # 5");
+      real[i] = values[i].real();
     }
-    LR = Solver::DecomposeLR(LR);
+    Tridiagonalize(B, d, e, tau, 32, workers);
+    InverseIteration(d, e, real, vectors, workers);
+  } else {
+    ReduceHessenberg(B, tau, 32, workers);
+    InverseIteration(B, values, vectors, workers);
   }
+  ApplyQ(B, tau, vectors, workers);
+}
 
-  return values;
-}
\ No newline at end of file
+void Solver::EigenVectors(const Matrix &A, const std::vector<double> &values,
+                          Matrix &vectors) {
+  EigenVectors(A, std::vector<Complex>(values.begin(), values.end()), vectors);
+}
@@ -1,10 +1,122 @@
+#pragma once
 #include "matrix.h"
+#include <complex>
+#include <functional>
 #include <vector>
 
 namespace Solver {
-void AlignRow(Matrix &row, const std::vector<Matrix *> &rest);
-void Align(Matrix &A, Matrix *B = nullptr);
-void QuasiTriangulate(Matrix &A, Matrix *B = nullptr);
+// Storage of DecomposeLR and EigenValues for matrices up to n x n. Created
+// once and passed to every call, so the reductions and iterations allocate
+// nothing on the heap.
+class Workspace {
+public:
+  explicit Workspace(int n);
+
+  int size() const;
+  // Views over the storage for an N x N matrix
+  Matrix LR(int N);
+  Matrix product(int N);
+  // Scratch row of the rotations, (row, cos, sin) for each of them
+  Matrix row(int N);
+
+  // Panels of the Hessenberg and tridiagonal reductions are this wide
+  static constexpr int kPanel = 32;
+  // Scratch of size doubles for the panels of one worker
+  double *panel(int size);
+  // Vectors with the capacity for n (offdiagonal for n + 1, as QL
+  // extends it), filled within it without reallocation
+  std::vector<double> &tau();
+  std::vector<double> &diagonal();
+  std::vector<double> &offdiagonal();
+  std::vector<std::complex<double>> &values();
+
+private:
+  Matrix view(int offset, int cols, int rows);
+
+  int _n;
+  std::vector<double> _data;
+  std::vector<double> _panel;
+  std::vector<double> _tau, _diagonal, _offdiagonal;
+  std::vector<std::complex<double>> _values;
+};
+
+// x = cos x - sin y, y = sin x + cos y in one pass over both rows
+void Rotate(double *x, double *y, int n, double cos, double sin);
+void AlignRow(Matrix &row, const std::vector<Matrix *> &rest,
+              Matrix *scratch = nullptr);
+// The same for the `count` matrices at rest, so no container is built per
+// call
+void AlignRow(Matrix &row, Matrix *const *rest, int count,
+              Matrix *scratch = nullptr);
+void Align(Matrix &A, Matrix *B = nullptr, Matrix *scratch = nullptr);
+void QuasiTriangulate(Matrix &A, Matrix *B = nullptr,
+                      Matrix *scratch = nullptr);
 Matrix DecomposeLR(Matrix &A);
-std::vector<double> EigenValues(Matrix &A);
+// L and R of A are packed into LR, which must be N x N
+void DecomposeLR(Matrix &A, Matrix &LR, Matrix *scratch = nullptr);
+// One event of the Schur iteration of EigenValues
+struct EigenEvent {
+  // A double-shift step, an exceptional one, a multishift sweep, or
+  // eigenvalues split off
+  enum class Kind { Step, Exceptional, Sweep, Deflation };
+  Kind kind = Kind::Step;
+  // Steps and sweeps before the event
+  int iteration = 0;
+  // Rows lo .. hi - 1: the window iterated on, or the rows split off
+  int lo = 0;
+  int hi = 0;
+  // Norm of the subdiagonal of the part not split off yet, after the event
+  double subdiagonal = 0;
+  std::vector<std::complex<double>> shifts;
+  std::vector<std::complex<double>> values;
+  // Time since the previous event
+  double seconds = 0;
+};
+using EigenObserver = std::function<void(const EigenEvent &)>;
+
+// Convergence of EigenValues
+struct EigenReport {
+  // Double-shift steps and multishift sweeps in total, and the shifts they
+  // applied
+  int iterations = 0;
+  int shifts = 0;
+  // Steps spent on each eigenvalue since the previous deflation, in the
+  // order of deflation
+  std::vector<int> steps;
+  // Called on every event when set, the only cost otherwise is a test. It
+  // is kept when EigenValues resets the report; an exception thrown from it
+  // stops the iterations.
+  EigenObserver observer;
+};
+
+// Eigenvalues of a general real matrix by the Francis QR algorithm on its
+// Hessenberg form, in descending order of real parts, a conjugate pair with
+// the positive imaginary part first. Symmetric matrices are detected and
+// solved by SymmetricEigenValues, the report then stays empty. A is
+// overwritten.
+void EigenValues(Matrix &A, std::vector<std::complex<double>> &values,
+                 EigenReport *report = nullptr);
+// The same for a matrix known to have real eigenvalues, a complex pair is
+// reported as Solver error # 5
+std::vector<double> EigenValues(Matrix &A, EigenReport *report = nullptr);
+// The same with the reductions, the iterations and their vectors on the
+// storage of the workspace and one worker. values needs the capacity for
+// A.rows(); then below 75 rows (one double shift per sweep) nothing is
+// allocated, larger windows allocate the scratch of their multishift
+// sweeps.
+void EigenValues(Matrix &A, Workspace &workspace, std::vector<double> &values,
+                 EigenReport *report = nullptr);
+
+// Eigenvectors of A for some or all of its eigenvalues as EigenValues gives
+// them, a pair kept together, into the columns of vectors
+// (n x values.size()): a real value gives its unit vector, a pair a + bi,
+// a - bi the real and imaginary parts of the unit vector of a + bi. Inverse
+// iteration runs on the Hessenberg form, or on the tridiagonal one for a
+// symmetric A, and costs O(n^2) per vector after the O(n^3) reduction; the
+// vectors are found in parallel and brought back by the reflectors.
+void EigenVectors(const Matrix &A,
+                  const std::vector<std::complex<double>> &values,
+                  Matrix &vectors);
+void EigenVectors(const Matrix &A, const std::vector<double> &values,
+                  Matrix &vectors);
 }; // namespace Solver
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "symmetric.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include "parallel.h"
+#include "tridiagonal.h"
+
+bool Solver::IsSymmetric(const Matrix &A) {
+  if (A.cols() != A.rows())
+    return false;
+  for (int j = 0; j < A.rows(); ++j)
+    for (int i = 0; i < j; ++i) {
+      double a = A[{i, j}];
+      double b = A[{j, i}];
+      if (std::abs(a - b) > 1e-14 * std::max(std::abs(a), std::abs(b)))
+        return false;
+    }
+  return true;
+}
+
+// Scratch of Fold in doubles: V, W, y, z and v
+int FoldSize(int n, int nb) { return 2 * n * nb + 2 * nb + n; }
+
+// Tridiagonalize with panels of nb columns on scratch of FoldSize
+void Fold(Matrix &A, std::vector<double> &d, std::vector<double> &e,
+          std::vector<double> &tau, int nb, int workers, double *scratch) {
+  int n = A.rows();
+  d.assign(n, 0.0);
+  e.assign(std::max(n - 1, 0), 0.0);
+  tau.assign(n, 0.0);
+
+  // The trailing matrix is kept full, so A v runs along rows
+  for (int r = 0; r < n; ++r)
+    for (int c = r + 1; c < n; ++c)
+      A[{c, r}] = A[{r, c}];
+
+  // V and W = A V T-like corrections are n x nb by rows
+  double *V = scratch;
+  double *W = V + n * nb;
+  double *y = W + n * nb;
+  double *z = y + nb;
+  double *v = z + nb;
+  auto row = [&A](int r) { return &A[{0, r}]; };
+
+  for (int k0 = 0; k0 < n; k0 += nb) {
+    int k1 = std::min(k0 + nb, n);
+    int b = k1 - k0;
+    std::fill(V, V + n * nb, 0.0);
+    std::fill(W, W + n * nb, 0.0);
+
+    for (int p = 0; p < b; ++p) {
+      int j = k0 + p;
+      // Column j gets the reflectors of the panel so far
+      for (int r = j; r < n; ++r) {
+        double s = 0;
+        for (int q = 0; q < p; ++q)
+          s += V[r * nb + q] * W[j * nb + q] + W[r * nb + q] * V[j * nb + q];
+        row(r)[j] -= s;
+      }
+      d[j] = row(j)[j];
+      if (j == n - 1)
+        break;
+
+      // Reflector that zeroes a_j below row j + 1
+      double x = row(j + 1)[j];
+      double sigma = 0;
+      for (int r = j + 2; r < n; ++r)
+        sigma += row(r)[j] * row(r)[j];
+      double t = 0;
+      double beta = x;
+      std::fill(v, v + n, 0.0);
+      v[j + 1] = 1;
+      if (sigma > 0) {
+        beta = -std::copysign(sqrt(x * x + sigma), x);
+        double scale = 1 / (x - beta);
+        for (int r = j + 2; r < n; ++r) {
+          row(r)[j] *= scale;
+          v[r] = row(r)[j];
+        }
+        t = (beta - x) / beta;
+      }
+      row(j + 1)[j] = beta;
+      e[j] = beta;
+      tau[j] = t;
+      for (int r = j + 1; r < n; ++r)
+        V[r * nb + p] = v[r];
+
+      // w = t (A v - V W^T v - W V^T v) - t / 2 (w^T v) v, the trailing
+      // matrix is untouched since the start of the panel
+      for (int q = 0; q < p; ++q) {
+        double sy = 0;
+        double sz = 0;
+        for (int r = j + 1; r < n; ++r) {
+          sy += W[r * nb + q] * v[r];
+          sz += V[r * nb + q] * v[r];
+        }
+        y[q] = sy;
+        z[q] = sz;
+      }
+      Parallel(workers, [&](int worker) {
+        int first, last;
+        Share(worker, workers, j + 1, n, first, last);
+        for (int r = first; r < last; ++r) {
+          const double *a = row(r);
+          double s = 0;
+          for (int c = j + 1; c < n; ++c)
+            s += a[c] * v[c];
+          for (int q = 0; q < p; ++q)
+            s -= V[r * nb + q] * y[q] + W[r * nb + q] * z[q];
+          W[r * nb + p] = t * s;
+        }
+      });
+      double alpha = 0;
+      for (int r = j + 1; r < n; ++r)
+        alpha += W[r * nb + p] * v[r];
+      alpha *= -t / 2;
+      for (int r = j + 1; r < n; ++r)
+        W[r * nb + p] += alpha * v[r];
+    }
+    if (k1 >= n)
+      break;
+
+    Parallel(workers, [&](int worker) {
+      int first, last;
+      Share(worker, workers, k1, n, first, last);
+      for (int r = first; r < last; ++r) {
+        double *a = row(r);
+        for (int q = 0; q < b; ++q) {
+          const double vr = V[r * nb + q];
+          const double wr = W[r * nb + q];
+          for (int c = k1; c < n; ++c)
+            a[c] -= vr * W[c * nb + q] + wr * V[c * nb + q];
+        }
+      }
+    });
+  }
+}
+
+void Solver::Tridiagonalize(Matrix &A, std::vector<double> &d,
+                            std::vector<double> &e, std::vector<double> &tau,
+                            int block, int workers) {
+  int n = A.rows();
+  if (A.cols() != n)
+    throw std::domain_error("Solver error # 2");
+  if (block < 1 || workers < 1)
+    throw std::domain_error("Solver error # 3");
+  int nb = std::max(std::min(block, n), 1);
+  std::vector<double> scratch(FoldSize(n, nb));
+  Fold(A, d, e, tau, nb, workers, scratch.data());
+}
+
+void Solver::Tridiagonalize(Matrix &A, Workspace &workspace) {
+  int n = A.rows();
+  if (A.cols() != n)
+    throw std::domain_error("Solver error # 2");
+  if (n > workspace.size())
+    throw std::range_error("Workspace error # 2");
+  int nb = std::min(Workspace::kPanel, n);
+  Fold(A, workspace.diagonal(), workspace.offdiagonal(), workspace.tau(), nb,
+       1, workspace.panel(FoldSize(n, nb)));
+}
+
+void Solver::ApplyQ(const Matrix &A, const std::vector<double> &tau,
+                    Matrix &Z, int workers) {
+  int n = A.rows();
+  if (Z.rows() != n)
+    throw std::domain_error("Solver error # 2");
+  int cols = Z.cols();
+  // Q Z = H_0 (H_1 (... H_(n-2) Z)), columns of Z shared among the workers
+  Parallel(workers, [&](int worker) {
+    int first, last;
+    Share(worker, workers, 0, cols, first, last);
+    std::vector<double> s(last - first);
+    for (int j = n - 2; j >= 0; --j) {
+      if (tau[j] == 0 || first == last)
+        continue;
+      auto v = [&A, j](int r) { return r == j + 1 ? 1.0 : A[{j, r}]; };
+      std::fill(s.begin(), s.end(), 0.0);
+      for (int r = j + 1; r < n; ++r) {
+        double vr = v(r);
+        const double *z = &Z[{first, r}];
+        for (int c = 0; c < last - first; ++c)
+          s[c] += vr * z[c];
+      }
+      for (int r = j + 1; r < n; ++r) {
+        double vr = tau[j] * v(r);
+        double *z = &Z[{first, r}];
+        for (int c = 0; c < last - first; ++c)
+          z[c] -= vr * s[c];
+      }
+    }
+  });
+}
+
+std::vector<double> Solver::SymmetricEigenValues(Matrix &A, Matrix *vectors) {
+  int n = A.rows();
+  if (vectors && (vectors->rows() != n || vectors->cols() != n))
+    throw std::domain_error("Solver error # 2");
+  int workers =
+      n < 256 ? 1 : std::max(1u, std::thread::hardware_concurrency());
+  std::vector<double> d, e, tau;
+  Tridiagonalize(A, d, e, tau, 32, workers);
+  DivideConquer(d, e, vectors, workers);
+  std::reverse(d.begin(), d.end());
+  if (vectors) {
+    ApplyQ(A, tau, *vectors, workers);
+    for (int r = 0; r < n; ++r) {
+      double *z = &(*vectors)[{0, r}];
+      std::reverse(z, z + n);
+    }
+  }
+  return d;
+}
+
+std::vector<double> Solver::SymmetricEigenValues(Matrix &A, double lower,
+                                                 double upper) {
+  int n = A.rows();
+  int workers =
+      n < 256 ? 1 : std::max(1u, std::thread::hardware_concurrency());
+  std::vector<double> d, e, tau;
+  Tridiagonalize(A, d, e, tau, 32, workers);
+  return Bisection(d, e, lower, upper, workers);
+}
+
+std::vector<double> Solver::SmallestEigenValues(Matrix &A, int k) {
+  int n = A.rows();
+  int workers =
+      n < 256 ? 1 : std::max(1u, std::thread::hardware_concurrency());
+  std::vector<double> d, e, tau;
+  Tridiagonalize(A, d, e, tau, 32, workers);
+  return Bisection(d, e, 0, std::min(k, n), workers);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <vector>
+
+#include "matrix.h"
+#include "solver.h"
+
+namespace Solver {
+bool IsSymmetric(const Matrix &A);
+
+// A = Q T Q^T with T tridiagonal: diagonal d, off-diagonal e. Only the
+// lower triangle is read. Reflectors H_j = I - tau_j v_j v_j^T are made in
+// panels of `block` columns; the panel keeps A V and the trailing matrix
+// is updated once per panel by A -= V W^T + W V^T, rows shared among the
+// workers. The vectors v_j are left below the subdiagonal of A,
+// v_j(j + 1) = 1.
+void Tridiagonalize(Matrix &A, std::vector<double> &d, std::vector<double> &e,
+                    std::vector<double> &tau, int block = 32, int workers = 1);
+// The same into the diagonal, offdiagonal and tau of the workspace, one
+// worker, allocates nothing
+void Tridiagonalize(Matrix &A, Workspace &workspace);
+// Z = Q Z for Q of Tridiagonalize, or of ReduceHessenberg, which leaves
+// its reflectors the same way
+void ApplyQ(const Matrix &A, const std::vector<double> &tau, Matrix &Z,
+            int workers = 1);
+
+// Eigenvalues of a symmetric matrix in descending order by
+// tridiagonalization and divide and conquer. With vectors (n x n) the
+// eigenvectors are left in its columns in the same order. A is overwritten.
+std::vector<double> SymmetricEigenValues(Matrix &A, Matrix *vectors = nullptr);
+// Only the eigenvalues in [lower, upper), or the k smallest, in ascending
+// order: the tridiagonal form is sliced by bisection
+std::vector<double> SymmetricEigenValues(Matrix &A, double lower,
+                                         double upper);
+std::vector<double> SmallestEigenValues(Matrix &A, int k);
+} // namespace Solver
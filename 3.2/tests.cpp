@@ -1,8 +1,34 @@
+#include "francis.h"
+#include "hessenberg.h"
+#include "krylov.h"
 #include "matrix.h"
 #include "solver.h"
+#include "symmetric.h"
 #include "test_runner.h"
+#include "trace.h"
+#include "tridiagonal.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
+#include <complex>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <sstream>
+
+// Every heap allocation of the program, Matrix::allocations counts only
+// the buffers of matrices
+std::atomic<long> heap_allocations{0};
+
+void *operator new(std::size_t size) {
+  ++heap_allocations;
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
 
 std::ostream &operator<<(std::ostream &os, const MatrixSize &s) {
   return os << "(" << s.col << ", " << s.row << ")";
@@ -118,6 +144,517 @@ void EigenValues() {
       ASSERT_EQUAL(v[i], output_v[i]);
   }
 }
+
+void Workspace() {
+  // DecomposeLR on the storage of a workspace allocates nothing
+  {
+    int n = 40;
+    Matrix A(n, [](int i, int j) { return std::sin(i * 0.37 + j * j * 0.11); });
+    Solver::Workspace workspace(n);
+    Matrix LR = workspace.LR(n);
+    Matrix scratch = workspace.row(n);
+    for (int r = 0; r < 3; ++r) {
+      Matrix A1 = A;
+      long before = heap_allocations;
+      Solver::DecomposeLR(A1, LR, &scratch);
+      long allocated = heap_allocations - before;
+      ASSERT_EQUAL(allocated, 0L);
+    }
+  }
+  // So does EigenValues on a symmetric matrix and on a general one with
+  // disjoint Gershgorin discs, hence real eigenvalues
+  int n = 40;
+  Matrix S(n, [](int i, int j) { return i == j ? i + 1.0 : 0.01 / (i + j); });
+  Matrix G(n, [](int i, int j) {
+    return i == j ? i + 1.0 : 0.01 * std::sin(i * 0.37 + j * j * 0.11);
+  });
+  Solver::Workspace workspace(n + 2);
+  std::vector<double> v;
+  v.reserve(n);
+  for (const Matrix *A : {&S, &G}) {
+    Matrix A1 = *A;
+    auto expected = Solver::EigenValues(A1);
+    for (int r = 0; r < 3; ++r) {
+      Matrix A2 = *A;
+      long before = heap_allocations;
+      Solver::EigenValues(A2, workspace, v);
+      long allocated = heap_allocations - before;
+      ASSERT_EQUAL(allocated, 0L);
+      for (int i = 0; i < n; ++i)
+        ASSERT_EQUAL(v[i], expected[i]);
+    }
+  }
+}
+
+void Rotations() {
+  // Wider than one tile of columns, with entries below 1 in magnitude
+  int n = 300;
+  Matrix A(n, [](int i, int j) { return sin(i * 0.37 + j * j * 0.11); });
+  Matrix A1 = A;
+  Solver::Align(A1);
+  for (int i = 0; i < n; ++i) {
+    for (int j = i + 1; j < n; ++j)
+      ASSERT(std::abs(A1.at(i, j)) < 1e-9);
+    ASSERT(std::abs(A1.col(i).norm() - A.col(i).norm()) < 1e-9);
+  }
+
+  double x[] = {1, 2, 3};
+  double y[] = {4, 5, 6};
+  Solver::Rotate(x, y, 3, 0.6, 0.8);
+  ASSERT(std::abs(x[2] - (0.6 * 3 - 0.8 * 6)) < 1e-15);
+  ASSERT(std::abs(y[2] - (0.8 * 3 + 0.6 * 6)) < 1e-15);
+}
+
+void HessenbergReduction() {
+  // Panels of 8 columns with a remainder, shared among 3 workers
+  int n = 45;
+  Matrix A(n, [](int i, int j) { return sin(i * i * 0.3 + j * 0.7 + i * j); });
+  Matrix H = A;
+  std::vector<double> tau;
+  Solver::ReduceHessenberg(H, tau, 8, 3);
+  Matrix H1 = A;
+  Solver::Hessenberg(H1);
+
+  // Q = H_0 ... H_(n-3) built from the stored reflectors, Q^T A Q = H
+  Matrix Q(n, [](int i, int j) { return double(i == j); });
+  for (int j = n - 3; j >= 0; --j)
+    for (int c = 0; c < n; ++c) {
+      double s = Q.at(c, j + 1);
+      for (int r = j + 2; r < n; ++r)
+        s += H.at(j, r) * Q.at(c, r);
+      Q.at(c, j + 1) -= tau[j] * s;
+      for (int r = j + 2; r < n; ++r)
+        Q.at(c, r) -= tau[j] * s * H.at(j, r);
+    }
+  Matrix Qt(n, [&Q](int i, int j) { return Q.at(j, i); });
+  Matrix B = Qt * A * Q;
+  for (int j = 0; j < n; ++j)
+    for (int i = 0; i < n; ++i) {
+      double h = i + 1 >= j ? H.at(i, j) : 0.0;
+      ASSERT(std::abs(B.at(i, j) - h) < 1e-12);
+      ASSERT(std::abs(H1.at(i, j) - h) < 1e-12);
+    }
+}
+
+void HessenbergSteps() {
+  {
+    Matrix H(5,
+             [](int i, int j) { return sin(i * i * 0.3 + j * 0.7 + i * j); });
+    Solver::Hessenberg(H, 1);
+    auto traces = [](const Matrix &M) {
+      double t1 = 0, t2 = 0;
+      for (int i = 0; i < M.rows(); ++i) {
+        t1 += M[{i, i}];
+        for (int k = 0; k < M.rows(); ++k)
+          t2 += M[{i, k}] * M[{k, i}];
+      }
+      return std::make_pair(t1, t2);
+    };
+    auto before = traces(H);
+    Solver::QRStep(H);
+    if (!Solver::LRStep(H))
+      Solver::QRStep(H);
+    auto after = traces(H);
+    ASSERT(std::abs(before.first - after.first) < 1e-10);
+    ASSERT(std::abs(before.second - after.second) < 1e-9);
+    for (int j = 0; j < 5; ++j)
+      for (int i = 0; i < j - 1; ++i)
+        ASSERT(std::abs(H[{i, j}]) < 1e-12);
+  }
+  {
+    double input_A[] = {4, 1, 0, 1, 3, 1, 0, 1, 2};
+    Matrix A(3, 3, input_A);
+    A.release();
+    auto v = Solver::EigenValues(A);
+    std::sort(v.begin(), v.end());
+    ASSERT(std::abs(v[0] - (3 - sqrt(3))) < 1e-6);
+    ASSERT(std::abs(v[1] - 3) < 1e-6);
+    ASSERT(std::abs(v[2] - (3 + sqrt(3))) < 1e-6);
+  }
+}
+
+void ShiftedEigenValues() {
+  int n = 20;
+  {
+    // Eigenvalues 1, -2, 3, ... of a triangular matrix, hidden by a
+    // reflection H T H
+    auto d = [](int j) { return (j + 1.0) * (j % 2 ? -1 : 1); };
+    Matrix T(n, [&d](int i, int j) {
+      return i == j ? d(j) : i > j ? sin(i * 0.7 + j * 1.3) : 0.0;
+    });
+    double norm = 0;
+    for (int j = 0; j < n; ++j)
+      norm += cos(j * 0.9) * cos(j * 0.9);
+    Matrix H(n, [norm](int i, int j) {
+      return (i == j) - 2 * cos(i * 0.9) * cos(j * 0.9) / norm;
+    });
+    Matrix A = H * T * H;
+    Solver::EigenReport report;
+    auto v = Solver::EigenValues(A, &report);
+    std::vector<double> expected(n);
+    for (int j = 0; j < n; ++j)
+      expected[j] = d(j);
+    std::sort(expected.begin(), expected.end(), std::greater<double>());
+    for (int i = 0; i < n; ++i)
+      ASSERT_EQUAL(v[i], expected[i]);
+    ASSERT_EQUAL(static_cast<int>(report.steps.size()), n);
+    ASSERT(report.iterations < 5 * n);
+  }
+  {
+    // Rotation by 90 degrees, eigenvalues +-i
+    double input_A[] = {0, -1, 1, 0};
+    Matrix A(2, 2, input_A);
+    A.release();
+    bool thrown = false;
+    try {
+      Solver::EigenValues(A);
+    } catch (std::runtime_error &) {
+      thrown = true;
+    }
+    ASSERT(thrown);
+  }
+}
+
+void Francis() {
+  using Complex = std::complex<double>;
+  {
+    // (x - 1)(x^2 + 1) by its companion matrix
+    double input_A[] = {1, -1, 1, 1, 0, 0, 0, 1, 0};
+    Matrix A(3, 3, input_A);
+    A.release();
+    std::vector<Complex> v;
+    Solver::EigenValues(A, v);
+    ASSERT(std::abs(v[0] - 1.0) < 1e-12);
+    ASSERT(std::abs(v[1] - Complex(0, 1)) < 1e-12);
+    ASSERT(std::abs(v[2] - Complex(0, -1)) < 1e-12);
+  }
+  {
+    // A chain of two bulges is the same as two double-shift steps
+    int n = 40;
+    Matrix H(n, [](int i, int j) {
+      return j > i + 1 ? 0.0 : sin(i * i * 0.3 + j * 0.7 + i * j);
+    });
+    Matrix H1 = H;
+    std::vector<Complex> shifts = {Complex(0.5, 1), Complex(0.5, -1), 2, -1};
+    Solver::MultishiftSweep(H, 0, n, shifts, 2);
+    Solver::FrancisStep(H1, 0, n, 1, 1.25);
+    Solver::FrancisStep(H1, 0, n, 1, -2);
+    for (int j = 0; j < n; ++j)
+      for (int i = 0; i < n; ++i)
+        ASSERT(std::abs(H.at(i, j) - H1.at(i, j)) < 1e-10);
+  }
+  {
+    // Eigenvalues -j / 2 and pairs j / 10 +- (1 + j / 20) i of a block
+    // triangular matrix hidden by a reflection, large enough for
+    // multishift sweeps
+    int n = 160;
+    Matrix T(n, [](int i, int j) {
+      return i > j + 1 ? cos(i * 0.3 + j * 1.1) : 0.0;
+    });
+    std::vector<Complex> expected;
+    for (int k = 0; k < n;)
+      if (k % 3 == 0 && k + 1 < n) {
+        double re = k * 0.1;
+        double im = 1 + k * 0.05;
+        T.at(k, k) = T.at(k + 1, k + 1) = re;
+        T.at(k + 1, k) = im;
+        T.at(k, k + 1) = -im;
+        expected.push_back(Complex(re, im));
+        expected.push_back(Complex(re, -im));
+        k += 2;
+      } else {
+        T.at(k, k) = -0.5 * k;
+        expected.push_back(-0.5 * k);
+        ++k;
+      }
+    double norm = 0;
+    for (int j = 0; j < n; ++j)
+      norm += cos(j * 0.9) * cos(j * 0.9);
+    Matrix H(n, [norm](int i, int j) {
+      return (i == j) - 2 * cos(i * 0.9) * cos(j * 0.9) / norm;
+    });
+    Matrix A = H * T * H;
+    std::vector<Complex> v;
+    Solver::EigenReport report;
+    Solver::EigenValues(A, v, &report);
+    std::sort(expected.begin(), expected.end(), [](Complex x, Complex y) {
+      return x.real() != y.real() ? x.real() > y.real() : x.imag() > y.imag();
+    });
+    for (int i = 0; i < n; ++i)
+      ASSERT(std::abs(v[i] - expected[i]) < 1e-9);
+    ASSERT(report.shifts > 2 * report.iterations);
+  }
+}
+
+void Symmetric() {
+  {
+    Matrix A(3, [](int i, int j) { return i + j; });
+    ASSERT(Solver::IsSymmetric(A));
+    A.at(0, 2) += 1e-3;
+    ASSERT(!Solver::IsSymmetric(A));
+  }
+  {
+    // Eigenpairs of a symmetric 60 x 60, values as the Hessenberg path
+    int n = 60;
+    Matrix A(n, [](int i, int j) {
+      return 1 / (1.0 + std::abs(i - j)) + sin(i + j);
+    });
+    Matrix A1 = A;
+    Matrix Z(n, n);
+    auto v = Solver::SymmetricEigenValues(A1, &Z);
+    ASSERT(std::is_sorted(v.rbegin(), v.rend()));
+    Matrix AZ = A * Z;
+    for (int i = 0; i < n; ++i)
+      for (int r = 0; r < n; ++r)
+        ASSERT(std::abs(AZ.at(i, r) - v[i] * Z.at(i, r)) < 1e-12);
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j) {
+        double s = 0;
+        for (int r = 0; r < n; ++r)
+          s += Z.at(i, r) * Z.at(j, r);
+        ASSERT(std::abs(s - (i == j)) < 1e-12);
+      }
+
+    Matrix H = A;
+    Solver::Hessenberg(H);
+    std::vector<std::complex<double>> w(n);
+    Solver::Schur(H, 0, n, w);
+    std::sort(w.begin(), w.end(), [](std::complex<double> x,
+                                     std::complex<double> y) {
+      return x.real() > y.real();
+    });
+    for (int i = 0; i < n; ++i)
+      ASSERT(std::abs(w[i] - v[i]) < 1e-12);
+  }
+  {
+    // Wilkinson's W_61, its largest eigenvalues come in pairs equal to
+    // far beyond working precision
+    int n = 61;
+    std::vector<double> d(n), e(n - 1, 1.0);
+    for (int i = 0; i < n; ++i)
+      d[i] = std::abs(30 - i);
+    std::vector<double> values = d;
+    Matrix Z(n, n);
+    Solver::DivideConquer(values, e, &Z, 2);
+    ASSERT(std::is_sorted(values.begin(), values.end()));
+    ASSERT(std::abs(values[n - 1] - values[n - 2]) < 1e-12);
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j) {
+        double s = 0;
+        for (int r = 0; r < n; ++r)
+          s += Z.at(i, r) * Z.at(j, r);
+        ASSERT(std::abs(s - (i == j)) < 1e-12);
+      }
+    std::vector<double> only = d;
+    Solver::DivideConquer(only, e);
+    for (int i = 0; i < n; ++i)
+      ASSERT(std::abs(only[i] - values[i]) < 1e-12);
+  }
+}
+
+void Slicing() {
+  // W_61^-: symmetric tridiagonal, eigenvalues from -30 to 30 in close pairs
+  const int n = 61;
+  std::vector<double> d(n), e(n - 1, 1.0);
+  for (int i = 0; i < n; ++i)
+    d[i] = std::abs(30 - i);
+  std::vector<double> all = d;
+  Solver::DivideConquer(all, e);
+
+  ASSERT_EQUAL(Solver::CountBelow(d, e, -1e3), 0);
+  ASSERT_EQUAL(Solver::CountBelow(d, e, 1e3), n);
+  auto some = Solver::Bisection(d, e, 10, 20, 2);
+  ASSERT_EQUAL(static_cast<int>(some.size()), 10);
+  for (int i = 0; i < 10; ++i)
+    ASSERT(std::abs(some[i] - all[10 + i]) < 1e-12 * (1 + std::abs(all[i])));
+
+  auto inside = Solver::Bisection(d, e, 5.0, 15.0, 3);
+  int count = Solver::CountBelow(d, e, 15.0) - Solver::CountBelow(d, e, 5.0);
+  ASSERT_EQUAL(static_cast<int>(inside.size()), count);
+  for (double x : inside)
+    ASSERT(x >= 5 && x < 15);
+
+  Matrix A(20, [](int i, int j) { return 1.0 / (1 + i + j); });
+  Matrix B = A;
+  auto values = Solver::EigenValues(B);
+  B = A;
+  auto smallest = Solver::SmallestEigenValues(B, 3);
+  ASSERT_EQUAL(static_cast<int>(smallest.size()), 3);
+  for (int i = 0; i < 3; ++i)
+    ASSERT(std::abs(smallest[i] - values[19 - i]) < 1e-12);
+  B = A;
+  auto large = Solver::SymmetricEigenValues(B, 0.1, 10.0);
+  ASSERT_EQUAL(static_cast<int>(large.size()),
+               std::count_if(values.begin(), values.end(),
+                             [](double x) { return x >= 0.1 && x < 10; }));
+}
+
+void Krylov() {
+  // Tridiagonal operator of size 2000 given by a formula, never stored
+  const int n = 2000;
+  auto diagonal = [](int i) { return i * (i + 1.0) / 1000; };
+  Solver::Operator T = [&](const double *x, double *y) {
+    for (int i = 0; i < n; ++i)
+      y[i] = diagonal(i) * x[i] + (i > 0 ? x[i - 1] : 0) +
+             (i + 1 < n ? x[i + 1] : 0);
+  };
+  std::vector<double> d(n), e(n - 1, 1.0);
+  for (int i = 0; i < n; ++i)
+    d[i] = diagonal(i);
+  Solver::DivideConquer(d, e);
+
+  std::vector<double> values, residuals;
+  Solver::Lanczos(n, 4, T, values, residuals);
+  ASSERT_EQUAL(static_cast<int>(values.size()), 4);
+  for (int i = 0; i < 4; ++i) {
+    ASSERT(std::abs(values[i] - d[n - 1 - i]) < 1e-8 * d[n - 1]);
+    ASSERT(residuals[i] <= 1e-10 * std::abs(values[i]));
+  }
+  Solver::Operator negative = [&](const double *x, double *y) {
+    T(x, y);
+    for (int i = 0; i < n; ++i)
+      y[i] = -y[i];
+  };
+  Solver::Lanczos(n, 3, negative, values, residuals, Solver::Extreme::Smallest);
+  for (int i = 0; i < 3; ++i)
+    ASSERT(std::abs(values[i] + d[n - 1 - i]) < 1e-8 * d[n - 1]);
+
+  // Dense nonsymmetric, a pair +-500i leads in modulus
+  const int m = 300;
+  Matrix A(m, [](int c, int r) {
+    if (r < 2 && c < 2)
+      return r == c ? 0.0 : (r == 0 ? 500.0 : -500.0);
+    return (r == c ? r + 1.0 : 0.0) + 0.1 * std::sin(3.0 * r + 7.0 * c);
+  });
+  Matrix B = A;
+  std::vector<std::complex<double>> all;
+  Solver::EigenValues(B, all);
+  std::sort(all.begin(), all.end(),
+            [](const std::complex<double> &a, const std::complex<double> &b) {
+              return std::abs(a) > std::abs(b);
+            });
+  std::vector<std::complex<double>> ritz;
+  Solver::Arnoldi(m, 4, Solver::Product(A), ritz, residuals);
+  ASSERT_EQUAL(static_cast<int>(ritz.size()), 4);
+  ASSERT(ritz[0].imag() > 0 && std::abs(ritz[1] - std::conj(ritz[0])) < 1e-8);
+  for (int i = 0; i < 4; ++i) {
+    double nearest = 1e300;
+    for (const auto &x : all)
+      nearest = std::min(nearest, std::abs(x - ritz[i]));
+    ASSERT(nearest < 1e-8 * std::abs(all[0]));
+    ASSERT(std::abs(std::abs(ritz[i]) - std::abs(all[i])) <
+           1e-8 * std::abs(all[0]));
+  }
+}
+
+void EigenVectors() {
+  // W_21^+, the two largest eigenvalues agree to 14 digits
+  const int n = 21;
+  std::vector<double> d(n), e(n - 1, 1.0);
+  for (int i = 0; i < n; ++i)
+    d[i] = std::abs(10 - i);
+  std::vector<double> values = d;
+  Solver::DivideConquer(values, e);
+  Matrix Z(n, n);
+  Solver::InverseIteration(d, e, values, Z, 2);
+  for (int j = 0; j < n; ++j) {
+    for (int i = 0; i < n; ++i) {
+      double t = (d[i] - values[j]) * Z[{j, i}];
+      if (i > 0)
+        t += e[i - 1] * Z[{j, i - 1}];
+      if (i + 1 < n)
+        t += e[i] * Z[{j, i + 1}];
+      ASSERT(std::abs(t) < 1e-12);
+    }
+    for (int l = 0; l <= j; ++l) {
+      double s = 0;
+      for (int i = 0; i < n; ++i)
+        s += Z[{j, i}] * Z[{l, i}];
+      ASSERT_EQUAL(s, l == j ? 1.0 : 0.0);
+    }
+  }
+
+  // |A x - value x| for the vector in columns j (and j + 1 of a pair)
+  auto residual = [](const Matrix &A, const Matrix &V,
+                     const std::vector<std::complex<double>> &values, int j) {
+    int n = A.rows();
+    bool pair = values[j].imag() != 0;
+    auto x = [&](int r) {
+      return std::complex<double>(V[{j, r}], pair ? V[{j + 1, r}] : 0);
+    };
+    double worst = 0;
+    for (int r = 0; r < n; ++r) {
+      std::complex<double> s = -values[j] * x(r);
+      for (int c = 0; c < n; ++c)
+        s += A[{c, r}] * x(c);
+      worst = std::max(worst, std::abs(s));
+    }
+    return worst;
+  };
+  const int m = 60;
+  Matrix A(m, [](int c, int r) { return std::sin(1.0 + r * 7 + c * c); });
+  Matrix B = A;
+  std::vector<std::complex<double>> all;
+  Solver::EigenValues(B, all);
+  ASSERT(std::any_of(all.begin(), all.end(),
+                     [](std::complex<double> x) { return x.imag() != 0; }));
+  Matrix V(m, m);
+  Solver::EigenVectors(A, all, V);
+  for (int j = 0; j < m; ++j)
+    ASSERT(residual(A, V, all, j) < 1e-10);
+
+  Matrix S(m, [](int c, int r) { return 1.0 / (1 + r + c) + (r == c) * r; });
+  B = S;
+  auto real = Solver::EigenValues(B);
+  Solver::EigenVectors(S, real, V);
+  std::vector<std::complex<double>> wide(real.begin(), real.end());
+  for (int j = 0; j < m; ++j)
+    ASSERT(residual(S, V, wide, j) < 1e-10);
+}
+
+void Telemetry() {
+  const int n = 120;
+  Matrix A(n, [](int c, int r) { return std::sin(1.0 + r * 7 + c * c); });
+  std::vector<Solver::EigenEvent> events;
+  Solver::EigenReport report;
+  report.observer = [&](const Solver::EigenEvent &event) {
+    events.push_back(event);
+  };
+  Matrix B = A;
+  std::vector<std::complex<double>> values;
+  Solver::EigenValues(B, values, &report);
+
+  int iterations = 0, shifts = 0, deflated = 0;
+  for (const auto &event : events) {
+    ASSERT(event.seconds >= 0 && event.lo < event.hi);
+    if (event.kind == Solver::EigenEvent::Kind::Deflation) {
+      ASSERT_EQUAL(static_cast<int>(event.values.size()), event.hi - event.lo);
+      deflated += event.values.size();
+    } else {
+      ++iterations;
+      shifts += event.shifts.size();
+    }
+  }
+  ASSERT_EQUAL(iterations, report.iterations);
+  ASSERT_EQUAL(shifts, report.shifts);
+  ASSERT_EQUAL(deflated, n);
+  ASSERT_EQUAL(events.back().subdiagonal, 0.0);
+
+  std::ostringstream csv, json;
+  B = A;
+  report.observer = Solver::Trace(csv);
+  Solver::EigenValues(B, values, &report);
+  B = A;
+  report.observer = Solver::Trace(json, Solver::Trace::Format::JSON);
+  Solver::EigenValues(B, values, &report);
+  auto lines = [](const std::string &s) {
+    return static_cast<int>(std::count(s.begin(), s.end(), '\n'));
+  };
+  ASSERT_EQUAL(lines(csv.str()), static_cast<int>(events.size()) + 1);
+  ASSERT_EQUAL(lines(json.str()), static_cast<int>(events.size()));
+  ASSERT(csv.str().rfind("kind,iteration,lo,hi,", 0) == 0);
+  ASSERT(json.str().rfind("{\"kind\": ", 0) == 0);
+}
 } // namespace Test_Solver
 
 int main() {
@@ -127,5 +664,16 @@ int main() {
   RUN_TEST(tr, Test_Solver::QuasiTriangulate);
   RUN_TEST(tr, Test_Solver::Decompose);
   RUN_TEST(tr, Test_Solver::EigenValues);
+  RUN_TEST(tr, Test_Solver::Workspace);
+  RUN_TEST(tr, Test_Solver::Rotations);
+  RUN_TEST(tr, Test_Solver::HessenbergReduction);
+  RUN_TEST(tr, Test_Solver::HessenbergSteps);
+  RUN_TEST(tr, Test_Solver::ShiftedEigenValues);
+  RUN_TEST(tr, Test_Solver::Francis);
+  RUN_TEST(tr, Test_Solver::Symmetric);
+  RUN_TEST(tr, Test_Solver::Slicing);
+  RUN_TEST(tr, Test_Solver::Krylov);
+  RUN_TEST(tr, Test_Solver::EigenVectors);
+  RUN_TEST(tr, Test_Solver::Telemetry);
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "trace.h"
+#include <limits>
+#include <sstream>
+
+const char *KindName(Solver::EigenEvent::Kind kind) {
+  switch (kind) {
+  case Solver::EigenEvent::Kind::Step:
+    return "step";
+  case Solver::EigenEvent::Kind::Exceptional:
+    return "exceptional";
+  case Solver::EigenEvent::Kind::Sweep:
+    return "sweep";
+  default:
+    return "deflation";
+  }
+}
+
+// Complex numbers as re:im separated by spaces for CSV, as [re, im] pairs
+// for JSON
+void WriteValues(std::ostream &os, const std::vector<std::complex<double>> &x,
+                 Solver::Trace::Format format) {
+  bool json = format == Solver::Trace::Format::JSON;
+  os << (json ? "[" : "");
+  for (size_t i = 0; i < x.size(); ++i) {
+    if (i > 0)
+      os << (json ? ", " : " ");
+    if (json)
+      os << '[' << x[i].real() << ", " << x[i].imag() << ']';
+    else
+      os << x[i].real() << ':' << x[i].imag();
+  }
+  os << (json ? "]" : "");
+}
+
+Solver::Trace::Trace(std::ostream &out, Format format)
+    : _out(&out), _format(format) {
+  if (_format == Format::CSV)
+    *_out << "kind,iteration,lo,hi,subdiagonal,seconds,shifts,values\n";
+}
+
+void Solver::Trace::operator()(const EigenEvent &event) const {
+  // The line is formed first, so lines of concurrent solvers do not mix
+  std::ostringstream os;
+  os.precision(std::numeric_limits<double>::max_digits10);
+  if (_format == Format::CSV) {
+    os << KindName(event.kind) << ',' << event.iteration << ',' << event.lo
+       << ',' << event.hi << ',' << event.subdiagonal << ',' << event.seconds
+       << ',';
+    WriteValues(os, event.shifts, _format);
+    os << ',';
+    WriteValues(os, event.values, _format);
+  } else {
+    os << "{\"kind\": \"" << KindName(event.kind)
+       << "\", \"iteration\": " << event.iteration << ", \"lo\": " << event.lo
+       << ", \"hi\": " << event.hi << ", \"subdiagonal\": " << event.subdiagonal
+       << ", \"seconds\": " << event.seconds << ", \"shifts\": ";
+    WriteValues(os, event.shifts, _format);
+    os << ", \"values\": ";
+    WriteValues(os, event.values, _format);
+    os << '}';
+  }
+  os << '\n';
+  *_out << os.str();
+}
@@ -0,0 +1,22 @@
+#pragma once
+#include <ostream>
+
+#include "solver.h"
+
+namespace Solver {
+// Observer writing every event of EigenValues to a stream: CSV with a
+// header row, or JSON, one object per line.
+//   report.observer = Trace(file, Trace::Format::JSON);
+// The stream must outlive the iterations.
+class Trace {
+public:
+  enum class Format { CSV, JSON };
+  explicit Trace(std::ostream &out, Format format = Format::CSV);
+
+  void operator()(const EigenEvent &event) const;
+
+private:
+  std::ostream *_out;
+  Format _format;
+};
+} // namespace Solver
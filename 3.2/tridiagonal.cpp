@@ -0,0 +1,694 @@
+#include "tridiagonal.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+#include "parallel.h"
+
+// Problems of this size and smaller are solved by QL iterations
+constexpr int kLeaf = 25;
+
+// Eigenvalues of a subproblem in ascending order and rows of its
+// eigenvector matrix: all of them, or the first and the last
+struct Part {
+  std::vector<double> values;
+  std::vector<double> rows;
+  int count = 0;
+  int n = 0;
+
+  double *row(int i) { return &rows[static_cast<size_t>(i) * n]; }
+  const double *row(int i) const { return &rows[static_cast<size_t>(i) * n]; }
+  const double *first() const { return row(0); }
+  const double *last() const { return row(count - 1); }
+};
+
+// Implicit QL with Wilkinson shifts, the rotations are applied to the
+// n x n matrix z from the right unless it is null. e is overwritten and
+// grows by one element.
+void QL(std::vector<double> &d, std::vector<double> &e, double *z) {
+  int n = d.size();
+  e.push_back(0);
+  for (int l = 0; l < n; ++l) {
+    int m;
+    int iteration = 0;
+    do {
+      for (m = l; m < n - 1; ++m) {
+        double dd = std::abs(d[m]) + std::abs(d[m + 1]);
+        if (std::abs(e[m]) <= std::numeric_limits<double>::epsilon() * dd)
+          break;
+      }
+      if (m == l)
+        break;
+      if (iteration++ == 30 * n)
+        throw std::runtime_error("Solver error # 4");
+      double g = (d[l + 1] - d[l]) / (2 * e[l]);
+      double r = std::hypot(g, 1.0);
+      g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+      double s = 1;
+      double c = 1;
+      double p = 0;
+      int i = m - 1;
+      for (; i >= l; --i) {
+        double f = s * e[i];
+        double b = c * e[i];
+        r = std::hypot(f, g);
+        e[i + 1] = r;
+        if (r == 0) {
+          d[i + 1] -= p;
+          e[m] = 0;
+          break;
+        }
+        s = f / r;
+        c = g / r;
+        g = d[i + 1] - p;
+        r = (d[i] - g) * s + 2 * c * b;
+        p = s * r;
+        d[i + 1] = g + p;
+        g = c * r - b;
+        for (int k = 0; z && k < n; ++k) {
+          double *zk = z + static_cast<size_t>(k) * n;
+          f = zk[i + 1];
+          zk[i + 1] = s * zk[i] + c * f;
+          zk[i] = c * zk[i] - s * f;
+        }
+      }
+      if (r == 0 && i >= l)
+        continue;
+      d[l] -= p;
+      e[l] = g;
+      e[m] = 0;
+    } while (m != l);
+  }
+}
+
+// Columns of the rows of part reordered by order
+void Reorder(Part &part, const std::vector<int> &order) {
+  std::vector<double> values(part.n), rows(part.rows.size());
+  for (int j = 0; j < part.n; ++j) {
+    values[j] = part.values[order[j]];
+    for (int r = 0; r < part.count; ++r)
+      rows[static_cast<size_t>(r) * part.n + j] = part.row(r)[order[j]];
+  }
+  part.values = std::move(values);
+  part.rows = std::move(rows);
+}
+
+std::vector<int> Ascending(const std::vector<double> &values) {
+  std::vector<int> order(values.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&values](int a, int b) { return values[a] < values[b]; });
+  return order;
+}
+
+Part Leaf(const std::vector<double> &d, const std::vector<double> &e, int lo,
+          int hi, bool all) {
+  int n = hi - lo;
+  Part part;
+  part.n = n;
+  part.values.assign(d.begin() + lo, d.begin() + hi);
+  std::vector<double> z(static_cast<size_t>(n) * n, 0.0);
+  for (int i = 0; i < n; ++i)
+    z[static_cast<size_t>(i) * n + i] = 1;
+  std::vector<double> off(e.begin() + lo, e.begin() + hi - 1);
+  QL(part.values, off, z.data());
+  if (all) {
+    part.count = n;
+    part.rows = std::move(z);
+  } else {
+    part.count = n > 1 ? 2 : 1;
+    part.rows.assign(z.begin(), z.begin() + n);
+    if (n > 1)
+      part.rows.insert(part.rows.end(), z.end() - n, z.end());
+  }
+  Reorder(part, Ascending(part.values));
+  return part;
+}
+
+// Root of 1 + rho sum z_j^2 / (delta_j - mu) = 0 between the poles delta_i
+// and delta_(i + 1) (or above the last one), where delta are the poles
+// relative to the one nearer to the root; returns mu and that origin
+void Secular(const std::vector<double> &D, const std::vector<double> &z,
+             double rho, int i, int &origin, double &mu) {
+  int k = D.size();
+  double norm = 0;
+  for (double x : z)
+    norm += x * x;
+  double upper = i + 1 < k ? D[i + 1] : D[i] + rho * norm;
+  // The sign of f at the midpoint tells which pole is nearer
+  double middle = (D[i] + upper) / 2;
+  double f = 1;
+  for (int j = 0; j < k; ++j)
+    f += rho * z[j] * z[j] / (D[j] - middle);
+  // The bracket [a, b] of mu
+  double a, b;
+  if (i + 1 < k && f < 0) {
+    origin = i + 1;
+    a = middle - D[i + 1];
+    b = 0;
+  } else {
+    origin = i;
+    a = 0;
+    b = (i + 1 < k ? middle : upper) - D[i];
+  }
+
+  std::vector<double> delta(k);
+  for (int j = 0; j < k; ++j)
+    delta[j] = D[j] - D[origin];
+  mu = (a + b) / 2;
+  for (int iteration = 0; iteration < 200; ++iteration) {
+    double g = 1;
+    double dg = 0;
+    for (int j = 0; j < k; ++j) {
+      double t = z[j] / (delta[j] - mu);
+      g += rho * z[j] * t;
+      dg += rho * t * t;
+    }
+    if (g == 0)
+      break;
+    // f increases between the poles
+    if (g < 0)
+      a = mu;
+    else
+      b = mu;
+    double next = mu - g / dg;
+    if (!(next > a && next < b))
+      next = (a + b) / 2;
+    if (std::abs(next - mu) <=
+            2 * std::numeric_limits<double>::epsilon() * std::abs(mu) ||
+        b - a <= 2 * std::numeric_limits<double>::epsilon() *
+                     std::max(std::abs(a), std::abs(b)))
+      break;
+    mu = next;
+  }
+}
+
+// out = block V, rows split among the workers
+void MultiplyRows(const std::vector<double> &block, int count, int width,
+                  const std::vector<double> &V, int k, std::vector<double> &out,
+                  int stride, int workers) {
+  Parallel(workers, [&](int w) {
+    int first, last;
+    Share(w, workers, 0, count, first, last);
+    for (int r = first; r < last; ++r) {
+      const double *b = &block[static_cast<size_t>(r) * width];
+      double *o = &out[static_cast<size_t>(r) * stride];
+      std::fill(o, o + k, 0.0);
+      for (int j = 0; j < width; ++j) {
+        if (b[j] == 0)
+          continue;
+        const double *v = &V[static_cast<size_t>(j) * k];
+        for (int i = 0; i < k; ++i)
+          o[i] += b[j] * v[i];
+      }
+    }
+  });
+}
+
+// Eigen decomposition of diag(D) + rho z z^T from those of the halves
+Part Merge(Part &left, Part &right, double rho, bool all, int workers) {
+  int n1 = left.n;
+  int n = n1 + right.n;
+  const double eps = std::numeric_limits<double>::epsilon();
+
+  // The rank one term couples the last row of the left eigenvectors and
+  // the first row of the right ones; the rows of both blocks are kept in
+  // one matrix with the columns of the left block first
+  std::vector<double> D(n), z(n);
+  int count = all ? n : 2;
+  std::vector<double> block(static_cast<size_t>(count) * n, 0.0);
+  double sign = rho < 0 ? -1 : 1;
+  for (int j = 0; j < n1; ++j) {
+    D[j] = left.values[j];
+    z[j] = left.last()[j];
+  }
+  for (int j = 0; j < right.n; ++j) {
+    D[n1 + j] = right.values[j];
+    z[n1 + j] = sign * right.first()[j];
+  }
+  if (all) {
+    for (int r = 0; r < n1; ++r)
+      std::copy(left.row(r), left.row(r) + n1, &block[r * n]);
+    for (int r = 0; r < right.n; ++r)
+      std::copy(right.row(r), right.row(r) + right.n,
+                &block[(n1 + r) * n + n1]);
+  } else {
+    std::copy(left.first(), left.first() + n1, &block[0]);
+    std::copy(right.last(), right.last() + right.n, &block[n + n1]);
+  }
+  // |z| = sqrt 2, the term is 2 |rho| (z / sqrt 2) (z / sqrt 2)^T
+  for (double &x : z)
+    x /= sqrt(2.0);
+  rho = 2 * std::abs(rho);
+
+  std::vector<int> order = Ascending(D);
+  double dmax = 0;
+  for (double x : D)
+    dmax = std::max(dmax, std::abs(x));
+  double tol = 8 * eps * std::max(dmax, rho);
+
+  // Deflation: a negligible z_j leaves D_j with its column, close poles are
+  // rotated so that one of them gets z_j = 0
+  std::vector<int> kept, deflated;
+  auto rotate = [&block, count, n](int p, int q, double c, double s) {
+    for (int r = 0; r < count; ++r) {
+      double *b = &block[static_cast<size_t>(r) * n];
+      double x = b[p];
+      double y = b[q];
+      b[p] = c * x + s * y;
+      b[q] = c * y - s * x;
+    }
+  };
+  for (int idx : order) {
+    if (rho * std::abs(z[idx]) <= tol) {
+      deflated.push_back(idx);
+      continue;
+    }
+    if (!kept.empty()) {
+      int p = kept.back();
+      double t = std::hypot(z[p], z[idx]);
+      double c = z[idx] / t;
+      double s = -z[p] / t;
+      if (std::abs((D[idx] - D[p]) * c * s) <= tol) {
+        rotate(p, idx, c, s);
+        double dp = D[p] * c * c + D[idx] * s * s;
+        D[idx] = D[p] * s * s + D[idx] * c * c;
+        D[p] = dp;
+        z[idx] = t;
+        z[p] = 0;
+        kept.back() = idx;
+        deflated.push_back(p);
+        continue;
+      }
+    }
+    kept.push_back(idx);
+  }
+
+  int k = kept.size();
+  std::vector<double> Dk(k), zk(k), lambda(k);
+  for (int i = 0; i < k; ++i) {
+    Dk[i] = D[kept[i]];
+    zk[i] = z[kept[i]];
+  }
+  // The poles of the secular equation must stay ascending after rotations
+  std::vector<int> sorted = Ascending(Dk);
+  {
+    std::vector<double> d2(k), z2(k);
+    std::vector<int> k2(k);
+    for (int i = 0; i < k; ++i) {
+      d2[i] = Dk[sorted[i]];
+      z2[i] = zk[sorted[i]];
+      k2[i] = kept[sorted[i]];
+    }
+    Dk = std::move(d2);
+    zk = std::move(z2);
+    kept = std::move(k2);
+  }
+
+  // Roots in parallel, then z recomputed from them (Gu and Eisenstat), so
+  // that the eigenvectors are orthogonal to working precision
+  std::vector<int> origin(k);
+  std::vector<double> mu(k);
+  Parallel(workers, [&](int w) {
+    int first, last;
+    Share(w, workers, 0, k, first, last);
+    for (int i = first; i < last; ++i)
+      Secular(Dk, zk, rho, i, origin[i], mu[i]);
+  });
+  // D_j - lambda_i without cancellation
+  auto gap = [&](int j, int i) {
+    return (Dk[j] - Dk[origin[i]]) - mu[i];
+  };
+  std::vector<double> zhat(k);
+  for (int j = 0; j < k; ++j) {
+    double product = -gap(j, j) / rho;
+    for (int i = 0; i < k; ++i)
+      if (i != j)
+        product *= gap(j, i) / (Dk[j] - Dk[i]);
+    zhat[j] = std::copysign(sqrt(std::abs(product)), zk[j]);
+  }
+  // V is k x k by rows: V(j, i) = zhat_j / (D_j - lambda_i), normalized
+  std::vector<double> V(static_cast<size_t>(k) * k);
+  for (int i = 0; i < k; ++i) {
+    double norm = 0;
+    for (int j = 0; j < k; ++j) {
+      double v = zhat[j] / gap(j, i);
+      V[static_cast<size_t>(j) * k + i] = v;
+      norm += v * v;
+    }
+    norm = sqrt(norm);
+    for (int j = 0; j < k; ++j)
+      V[static_cast<size_t>(j) * k + i] /= norm;
+    lambda[i] = Dk[origin[i]] + mu[i];
+  }
+
+  // Columns: the kept ones times V, then the deflated ones as they are
+  std::vector<double> compact(static_cast<size_t>(count) * k);
+  for (int r = 0; r < count; ++r)
+    for (int j = 0; j < k; ++j)
+      compact[static_cast<size_t>(r) * k + j] = block[r * n + kept[j]];
+  Part merged;
+  merged.n = n;
+  merged.count = count;
+  merged.rows.assign(static_cast<size_t>(count) * n, 0.0);
+  MultiplyRows(compact, count, k, V, k, merged.rows, n, workers);
+  merged.values = lambda;
+  for (int j = 0; j < static_cast<int>(deflated.size()); ++j) {
+    merged.values.push_back(D[deflated[j]]);
+    for (int r = 0; r < count; ++r)
+      merged.row(r)[k + j] = block[r * n + deflated[j]];
+  }
+  Reorder(merged, Ascending(merged.values));
+  return merged;
+}
+
+Part Solve(std::vector<double> &d, const std::vector<double> &e, int lo,
+           int hi, bool all, int workers) {
+  if (hi - lo <= kLeaf)
+    return Leaf(d, e, lo, hi, all);
+  int m = lo + (hi - lo) / 2;
+  double rho = e[m - 1];
+  // T = diag(T1, T2) + |rho| u u^T with u = (e_(m-1), sign(rho) e_m)
+  d[m - 1] -= std::abs(rho);
+  d[m] -= std::abs(rho);
+  Part left, right;
+  if (workers > 1) {
+    int half = workers / 2;
+    Parallel(2, [&](int w) {
+      if (w == 0)
+        left = Solve(d, e, lo, m, all, half);
+      else
+        right = Solve(d, e, m, hi, all, workers - half);
+    });
+  } else {
+    left = Solve(d, e, lo, m, all, 1);
+    right = Solve(d, e, m, hi, all, 1);
+  }
+  return Merge(left, right, rho, all, workers);
+}
+
+void Solver::QLEigenValues(std::vector<double> &d, std::vector<double> &e) {
+  if (e.size() + 1 != d.size() && !(d.empty() && e.empty()))
+    throw std::domain_error("Solver error # 2");
+  QL(d, e, nullptr);
+  std::sort(d.begin(), d.end());
+}
+
+void Solver::DivideConquer(std::vector<double> &d,
+                           const std::vector<double> &e, Matrix *Z,
+                           int workers) {
+  int n = d.size();
+  if (static_cast<int>(e.size()) < n - 1)
+    throw std::domain_error("Solver error # 2");
+  if (workers < 1)
+    throw std::domain_error("Solver error # 3");
+  if (Z && (Z->rows() != n || Z->cols() != n))
+    throw std::domain_error("Solver error # 2");
+  if (n == 0)
+    return;
+  Part part = Solve(d, e, 0, n, Z != nullptr, workers);
+  d = part.values;
+  if (Z)
+    for (int r = 0; r < n; ++r)
+      std::copy(part.row(r), part.row(r) + n, &(*Z)[{0, r}]);
+}
+
+// Smallest pivot allowed in the Sturm count
+double PivotMin(const std::vector<double> &e) {
+  double max = 1;
+  for (double x : e)
+    max = std::max(max, x * x);
+  return std::numeric_limits<double>::min() * max;
+}
+
+int SturmCount(const std::vector<double> &d, const std::vector<double> &e,
+               double x, double pivmin) {
+  int n = d.size();
+  int count = 0;
+  double q = d[0] - x;
+  for (int i = 0;; ++i) {
+    if (std::abs(q) < pivmin)
+      q = -pivmin;
+    count += q < 0;
+    if (i + 1 == n)
+      break;
+    q = d[i + 1] - x - e[i] * e[i] / q;
+  }
+  return count;
+}
+
+int Solver::CountBelow(const std::vector<double> &d,
+                       const std::vector<double> &e, double x) {
+  if (d.empty())
+    return 0;
+  return SturmCount(d, e, x, PivotMin(e));
+}
+
+// Eigenvalues with indices first .. last - 1, all of them in [a, b]
+std::vector<double> Bisect(const std::vector<double> &d,
+                           const std::vector<double> &e, int first, int last,
+                           double a, double b, int workers) {
+  const double eps = std::numeric_limits<double>::epsilon();
+  double pivmin = PivotMin(e);
+  std::vector<double> values(std::max(last - first, 0));
+  Parallel(workers, [&](int w) {
+    int begin, end;
+    Share(w, workers, first, last, begin, end);
+    // The previous eigenvalue of the share bounds the next one from below
+    double floor = a;
+    for (int index = begin; index < end; ++index) {
+      double lo = floor;
+      double hi = b;
+      for (int iteration = 0; iteration < 200; ++iteration) {
+        double middle = (lo + hi) / 2;
+        if (hi - lo <= 2 * eps * std::max(std::abs(lo), std::abs(hi)) +
+                           pivmin ||
+            middle == lo || middle == hi)
+          break;
+        if (SturmCount(d, e, middle, pivmin) > index)
+          hi = middle;
+        else
+          lo = middle;
+      }
+      values[index - first] = floor = (lo + hi) / 2;
+    }
+  });
+  return values;
+}
+
+// Gershgorin bounds of the spectrum, slightly widened
+void Bounds(const std::vector<double> &d, const std::vector<double> &e,
+            double &lower, double &upper) {
+  int n = d.size();
+  lower = upper = d[0];
+  for (int i = 0; i < n; ++i) {
+    double radius = (i > 0 ? std::abs(e[i - 1]) : 0.0) +
+                    (i + 1 < n ? std::abs(e[i]) : 0.0);
+    lower = std::min(lower, d[i] - radius);
+    upper = std::max(upper, d[i] + radius);
+  }
+  double margin = 2 * std::numeric_limits<double>::epsilon() *
+                      std::max(std::abs(lower), std::abs(upper)) +
+                  PivotMin(e);
+  lower -= margin;
+  upper += margin;
+}
+
+std::vector<double> Solver::Bisection(const std::vector<double> &d,
+                                      const std::vector<double> &e,
+                                      double lower, double upper,
+                                      int workers) {
+  if (static_cast<int>(e.size()) + 1 < static_cast<int>(d.size()))
+    throw std::domain_error("Solver error # 2");
+  if (lower > upper || workers < 1)
+    throw std::domain_error("Solver error # 3");
+  if (d.empty())
+    return {};
+  double a, b;
+  Bounds(d, e, a, b);
+  a = std::max(a, lower);
+  b = std::min(b, upper);
+  if (a >= b)
+    return {};
+  double pivmin = PivotMin(e);
+  int first = SturmCount(d, e, lower, pivmin);
+  int last = SturmCount(d, e, upper, pivmin);
+  return Bisect(d, e, first, last, a, b, workers);
+}
+
+std::vector<double> Solver::Bisection(const std::vector<double> &d,
+                                      const std::vector<double> &e,
+                                      int first, int last, int workers) {
+  int n = d.size();
+  if (static_cast<int>(e.size()) + 1 < n)
+    throw std::domain_error("Solver error # 2");
+  if (first < 0 || last > n || first > last || workers < 1)
+    throw std::domain_error("Solver error # 3");
+  if (first == last)
+    return {};
+  double a, b;
+  Bounds(d, e, a, b);
+  return Bisect(d, e, first, last, a, b, workers);
+}
+
+// T - shift I = P L U with partial pivoting: multipliers l, the diagonal
+// and two superdiagonals of U, swapped[i] when rows i and i + 1 were
+// exchanged. Pivots below tiny are raised to it.
+struct Banded {
+  std::vector<double> l, u0, u1, u2;
+  std::vector<char> swapped;
+};
+
+void Factor(const std::vector<double> &d, const std::vector<double> &e,
+            double shift, double tiny, Banded &F) {
+  int n = d.size();
+  F.l.assign(e.begin(), e.begin() + n - 1);
+  F.u1.assign(e.begin(), e.begin() + n - 1);
+  F.u2.assign(n, 0.0);
+  F.u0.resize(n);
+  for (int i = 0; i < n; ++i)
+    F.u0[i] = d[i] - shift;
+  F.swapped.assign(n, 0);
+  auto raise = [tiny](double &x) {
+    if (std::abs(x) < tiny)
+      x = std::copysign(tiny, x);
+  };
+  for (int i = 0; i + 1 < n; ++i) {
+    if (std::abs(F.u0[i]) >= std::abs(F.l[i])) {
+      raise(F.u0[i]);
+      F.l[i] /= F.u0[i];
+      F.u0[i + 1] -= F.l[i] * F.u1[i];
+    } else {
+      double factor = F.u0[i] / F.l[i];
+      F.u0[i] = F.l[i];
+      F.l[i] = factor;
+      double temp = F.u1[i];
+      F.u1[i] = F.u0[i + 1];
+      F.u0[i + 1] = temp - factor * F.u0[i + 1];
+      if (i + 2 < n) {
+        F.u2[i] = F.u1[i + 1];
+        F.u1[i + 1] *= -factor;
+      }
+      F.swapped[i] = 1;
+    }
+  }
+  raise(F.u0[n - 1]);
+}
+
+// x = (T - shift I)^-1 x
+void Substitute(const Banded &F, std::vector<double> &x) {
+  int n = x.size();
+  for (int i = 0; i + 1 < n; ++i) {
+    if (F.swapped[i])
+      std::swap(x[i], x[i + 1]);
+    x[i + 1] -= F.l[i] * x[i];
+  }
+  for (int i = n - 1; i >= 0; --i) {
+    double s = x[i];
+    if (i + 1 < n)
+      s -= F.u1[i] * x[i + 1];
+    if (i + 2 < n)
+      s -= F.u2[i] * x[i + 2];
+    x[i] = s / F.u0[i];
+  }
+}
+
+double Length(const std::vector<double> &x) {
+  double sum = 0;
+  for (double v : x)
+    sum += v * v;
+  return std::sqrt(sum);
+}
+
+void Scale(std::vector<double> &x, double factor) {
+  for (double &v : x)
+    v *= factor;
+}
+
+// Unit 2-norm, the largest component positive
+void Normalize(std::vector<double> &x) {
+  double largest = 0;
+  for (double v : x)
+    if (std::abs(v) > std::abs(largest))
+      largest = v;
+  Scale(x, std::copysign(1 / Length(x), largest));
+}
+
+void Solver::InverseIteration(const std::vector<double> &d,
+                              const std::vector<double> &e,
+                              const std::vector<double> &values, Matrix &Z,
+                              int workers) {
+  int n = d.size();
+  int k = values.size();
+  if (n == 0 || static_cast<int>(e.size()) + 1 < n || Z.rows() != n ||
+      Z.cols() != k)
+    throw std::domain_error("Solver error # 2");
+  if (workers < 1)
+    throw std::domain_error("Solver error # 3");
+  const double eps = std::numeric_limits<double>::epsilon();
+  double norm = std::numeric_limits<double>::min();
+  for (int i = 0; i < n; ++i)
+    norm = std::max(norm, std::abs(d[i]) + (i > 0 ? std::abs(e[i - 1]) : 0) +
+                              (i + 1 < n ? std::abs(e[i]) : 0));
+  // The residual |T x - value x| an iteration may stop at
+  const double tolerance = 10 * n * eps * norm;
+
+  std::vector<int> clusters{0};
+  for (int j = 1; j < k; ++j)
+    if (std::abs(values[j] - values[j - 1]) > 1e-3 * norm)
+      clusters.push_back(j);
+  clusters.push_back(k);
+
+  Parallel(workers, [&](int w) {
+    int first, last;
+    Share(w, workers, 0, static_cast<int>(clusters.size()) - 1, first, last);
+    Banded F;
+    std::vector<std::vector<double>> vectors;
+    for (int c = first; c < last; ++c) {
+      vectors.clear();
+      double shift = 0;
+      for (int j = clusters[c]; j < clusters[c + 1]; ++j) {
+        // Equal values get shifts apart, so their iterations differ
+        double previous = shift;
+        shift = values[j];
+        if (j > clusters[c] && std::abs(shift - previous) < 10 * eps * norm)
+          shift = previous + 10 * eps * norm;
+        Factor(d, e, shift, eps * norm, F);
+
+        std::mt19937 gen(j + 1);
+        std::uniform_real_distribution<double> dist(-1, 1);
+        std::vector<double> x(n);
+        for (double &v : x)
+          v = dist(gen);
+        // Against the vectors of the cluster found so far
+        auto orthogonalize = [&]() {
+          for (const auto &z : vectors) {
+            double s = 0;
+            for (int i = 0; i < n; ++i)
+              s += z[i] * x[i];
+            for (int i = 0; i < n; ++i)
+              x[i] -= s * z[i];
+          }
+        };
+        for (int iteration = 0; iteration < 5; ++iteration) {
+          orthogonalize();
+          Scale(x, 1 / Length(x));
+          Substitute(F, x);
+          // |x| was 1, so the residual of x / growth is 1 / growth
+          double growth = Length(x);
+          Scale(x, 1 / growth);
+          if (1 / growth <= tolerance)
+            break;
+        }
+        orthogonalize();
+        Normalize(x);
+        for (int i = 0; i < n; ++i)
+          Z[{j, i}] = x[i];
+        vectors.push_back(std::move(x));
+      }
+    }
+  });
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <vector>
+
+#include "matrix.h"
+
+namespace Solver {
+// Eigenvalues of the symmetric tridiagonal matrix with diagonal d and
+// off-diagonal e (e[i] couples i and i + 1) into d in ascending order, by
+// divide and conquer. The halves of every split are solved concurrently
+// while workers last. With Z (n x n) the eigenvectors are left in its
+// columns; without it only the first and last rows of the eigenvector
+// matrices are kept through the merges, so the cost is O(n^2).
+void DivideConquer(std::vector<double> &d, const std::vector<double> &e,
+                   Matrix *Z = nullptr, int workers = 1);
+
+// Eigenvalues only into d in ascending order by implicit QL iterations,
+// O(n^2). e is overwritten and grows by one, so with the capacity for it
+// nothing is allocated.
+void QLEigenValues(std::vector<double> &d, std::vector<double> &e);
+
+// Number of eigenvalues of the tridiagonal matrix below x: the negative
+// pivots of T - x I = L D L^T (Sturm sequence)
+int CountBelow(const std::vector<double> &d, const std::vector<double> &e,
+               double x);
+// Eigenvalues in [lower, upper), or those with indices first .. last - 1 in
+// ascending order, by bisection on the Sturm count. Every eigenvalue is
+// bisected on its own, the eigenvalues are shared among the workers, so
+// the cost is O(n) per count and per requested eigenvalue.
+std::vector<double> Bisection(const std::vector<double> &d,
+                              const std::vector<double> &e, double lower,
+                              double upper, int workers = 1);
+std::vector<double> Bisection(const std::vector<double> &d,
+                              const std::vector<double> &e, int first,
+                              int last, int workers = 1);
+
+// Eigenvectors for the given eigenvalues, sorted either way, by inverse
+// iteration into the columns of Z (n x values.size()). T - value I is
+// factored once per value with partial pivoting in O(n), so each vector
+// costs O(n) per iteration. Values closer than 1e-3 |T| form a cluster
+// whose vectors are kept orthogonal; clusters are shared among the workers.
+void InverseIteration(const std::vector<double> &d,
+                      const std::vector<double> &e,
+                      const std::vector<double> &values, Matrix &Z,
+                      int workers = 1);
+} // namespace Solver
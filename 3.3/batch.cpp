@@ -0,0 +1,162 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <future>
+#include <limits>
+#include <stdexcept>
+
+constexpr int L = Batch::kLanes;
+
+Batch::Batch(int n, int count) : _n(n), _count(count) {
+  if (n < 1 || count < 1) throw std::domain_error("Batch error # 1");
+  _A.assign(static_cast<size_t>(groups()) * n * n * L, 0.0);
+  _b.assign(static_cast<size_t>(groups()) * n * L, 0.0);
+  _singular.assign(static_cast<size_t>(groups()) * L, 0);
+  // Padding lanes of the last group stay the identity, so they never fail
+  for (int g = 0; g < groups(); ++g)
+    for (int i = 0; i < n; ++i)
+      for (int l = 0; l < L; ++l) group_A(g)[(i * n + i) * L + l] = 1.0;
+}
+
+int Batch::size() const { return _n; }
+int Batch::count() const { return _count; }
+int Batch::groups() const { return (_count + L - 1) / L; }
+
+double &Batch::A(int system, int col, int row) {
+  if (system < 0 || system >= _count) throw std::range_error("Batch error # 2");
+  return _A[((system / L * _n + row) * _n + col) * L + system % L];
+}
+
+double Batch::A(int system, int col, int row) const {
+  if (system < 0 || system >= _count) throw std::range_error("Batch error # 3");
+  return _A[((system / L * _n + row) * _n + col) * L + system % L];
+}
+
+double &Batch::b(int system, int row) {
+  if (system < 0 || system >= _count) throw std::range_error("Batch error # 4");
+  return _b[(system / L * _n + row) * L + system % L];
+}
+
+double Batch::b(int system, int row) const {
+  if (system < 0 || system >= _count) throw std::range_error("Batch error # 5");
+  return _b[(system / L * _n + row) * L + system % L];
+}
+
+void Batch::set(int system, const Matrix &A, const Matrix &b) {
+  if (A.cols() != _n || A.rows() != _n || b.rows() != _n)
+    throw std::domain_error("Batch error # 6");
+  for (int j = 0; j < _n; ++j) {
+    for (int i = 0; i < _n; ++i) this->A(system, i, j) = A[{i, j}];
+    this->b(system, j) = b[{0, j}];
+  }
+}
+
+Matrix Batch::solution(int system) const {
+  Matrix x(1, _n);
+  for (int j = 0; j < _n; ++j) x[{0, j}] = b(system, j);
+  return x;
+}
+
+bool Batch::singular(int system) const {
+  if (system < 0 || system >= _count) throw std::range_error("Batch error # 7");
+  return _singular[system];
+}
+
+double *Batch::group_A(int group) {
+  return _A.data() + static_cast<size_t>(group) * _n * _n * L;
+}
+
+double *Batch::group_b(int group) {
+  return _b.data() + static_cast<size_t>(group) * _n * L;
+}
+
+char *Batch::group_singular(int group) { return _singular.data() + group * L; }
+
+// Gauss elimination with partial pivoting for one group of L systems.
+// Every innermost loop runs over the lanes, i.e. over different systems.
+// A singular lane goes on with a unit pivot, so its numbers stay finite,
+// and gets NaN as the solution at the end.
+void SolveGroup(double *A, double *b, char *singular, int n) {
+  auto a = [A, n](int col, int row) { return A + (row * n + col) * L; };
+  std::fill(singular, singular + L, 0);
+  for (int i = 0; i < n; ++i) {
+    int pivot[L];
+    double max[L];
+    for (int l = 0; l < L; ++l) {
+      pivot[l] = i;
+      max[l] = std::abs(a(i, i)[l]);
+    }
+    for (int j = i + 1; j < n; ++j) {
+      const double *p = a(i, j);
+      for (int l = 0; l < L; ++l)
+        if (std::abs(p[l]) > max[l]) {
+          max[l] = std::abs(p[l]);
+          pivot[l] = j;
+        }
+    }
+    for (int l = 0; l < L; ++l) {
+      if (max[l] < 1e-14) {
+        singular[l] = 1;
+        a(i, i)[l] = 1.0;
+        continue;
+      }
+      if (pivot[l] == i) continue;
+      for (int k = i; k < n; ++k) std::swap(a(k, i)[l], a(k, pivot[l])[l]);
+      std::swap(b[i * L + l], b[pivot[l] * L + l]);
+    }
+
+    double scale[L];
+    for (int l = 0; l < L; ++l) scale[l] = 1. / a(i, i)[l];
+    for (int k = i; k < n; ++k) {
+      double *p = a(k, i);
+      for (int l = 0; l < L; ++l) p[l] *= scale[l];
+    }
+    for (int l = 0; l < L; ++l) b[i * L + l] *= scale[l];
+
+    for (int j = i + 1; j < n; ++j) {
+      double factor[L];
+      for (int l = 0; l < L; ++l) factor[l] = a(i, j)[l];
+      for (int k = i; k < n; ++k) {
+        double *pj = a(k, j);
+        const double *pi = a(k, i);
+        for (int l = 0; l < L; ++l) pj[l] -= factor[l] * pi[l];
+      }
+      for (int l = 0; l < L; ++l) b[j * L + l] -= factor[l] * b[i * L + l];
+    }
+  }
+
+  for (int i = n - 1; i > 0; --i)
+    for (int j = 0; j < i; ++j) {
+      const double *p = a(i, j);
+      for (int l = 0; l < L; ++l) b[j * L + l] -= p[l] * b[i * L + l];
+    }
+
+  for (int l = 0; l < L; ++l)
+    if (singular[l])
+      for (int i = 0; i < n; ++i)
+        b[i * L + l] = std::numeric_limits<double>::quiet_NaN();
+}
+
+int Solver::Solve(Batch &batch, int workers) {
+  if (workers < 1) throw std::runtime_error("Solver error # 6");
+  const int N = batch.groups();
+  const int n = batch.size();
+  const int step = std::max(N / workers + (N % workers != 0), 1);
+
+  auto f = [&batch, n, N, step](int first) {
+    for (int g = first; g < std::min(first + step, N); ++g)
+      SolveGroup(batch.group_A(g), batch.group_b(g), batch.group_singular(g),
+                 n);
+  };
+  std::vector<std::future<void>> futures;
+  futures.reserve(workers);
+  int first = step;
+  for (; first < N; first += step) futures.push_back(std::async(f, first));
+  f(0);
+
+  for (auto &future : futures) future.get();
+  int singular = 0;
+  for (int s = 0; s < batch.count(); ++s) singular += batch.singular(s);
+  return singular;
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+
+#include "matrix.h"
+
+// A batch of equal-size systems A x = b in structure-of-arrays layout.
+// The same element of kLanes neighbouring systems is stored contiguously,
+// so one vector instruction updates kLanes different systems at once.
+class Batch {
+ public:
+  static constexpr int kLanes = 8;
+
+  Batch(int n, int count);
+
+  int size() const;
+  int count() const;
+  int groups() const;
+
+  double &A(int system, int col, int row);
+  double A(int system, int col, int row) const;
+  double &b(int system, int row);
+  double b(int system, int row) const;
+
+  void set(int system, const Matrix &A, const Matrix &b);
+  Matrix solution(int system) const;
+  // Set by Solver::Solve for a system whose pivot fell below 1e-14
+  bool singular(int system) const;
+
+  double *group_A(int group);
+  double *group_b(int group);
+  char *group_singular(int group);
+
+ private:
+  int _n;
+  int _count;
+  std::vector<double> _A;
+  std::vector<double> _b;
+  // One flag per lane, chars so that workers may write neighbours
+  std::vector<char> _singular;
+};
+
+namespace Solver {
+// Solves every system of the batch in place, b is replaced by x.
+// Groups of kLanes systems are spread over the workers. A singular system
+// does not stop the others: it is flagged in batch.singular() and its
+// solution is NaN. Returns the number of singular systems.
+int Solve(Batch &batch, int workers = 1);
+}  // namespace Solver
@@ -0,0 +1,195 @@
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "batch.h"
+#include "distributed.h"
+#include "matrix.h"
+#include "semiseparable.h"
+#include "solver.h"
+#include "svd.h"
+#include "utils.h"
+
+using Clock = std::chrono::steady_clock;
+
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Silences LOG_DURATION output of the solvers being measured
+class MuteErrors {
+ public:
+  MuteErrors() : _old(std::cerr.rdbuf(_sink.rdbuf())) {}
+  ~MuteErrors() { std::cerr.rdbuf(_old); }
+
+ private:
+  std::ostringstream _sink;
+  std::streambuf *_old;
+};
+
+void BenchBatch() {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  const int workers = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "Batched solve, systems per second\n";
+  std::cout << "n\tcount\tSolve\tbatch(1)\tbatch(" << workers << ")\n";
+  for (int n : {4, 8, 16, 32}) {
+    const int count = (1 << 22) / (n * n * n) * Batch::kLanes;
+    Batch batch(n, count);
+    for (int s = 0; s < count; ++s)
+      for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) batch.A(s, i, j) = dist(gen);
+        batch.A(s, j, j) += n;
+        batch.b(s, j) = dist(gen);
+      }
+
+    const int single = std::min(count, 20000);
+    auto start = Clock::now();
+    {
+      MuteErrors mute;
+      for (int s = 0; s < single; ++s) {
+        Matrix A(n, [&](int i, int j) { return batch.A(s, i, j); });
+        Matrix b(1, n, [&](int, int j) { return batch.b(s, j); });
+        Matrix x(1, n);
+        Solver::Solve(A, b, x);
+      }
+    }
+    double scalar = single / Seconds(start);
+
+    Batch copy = batch;
+    start = Clock::now();
+    Solver::Solve(copy, 1);
+    double one = count / Seconds(start);
+
+    start = Clock::now();
+    Solver::Solve(batch, workers);
+    double all = count / Seconds(start);
+
+    std::cout << n << '\t' << count << '\t' << scalar << '\t' << one << '\t'
+              << all << '\n';
+  }
+}
+
+void BenchSemiseparable() {
+  std::cout << "Generators k = 1, 2: dense Solve vs O(n) solver, seconds\n";
+  std::cout << "k\tn\tSolve\tSemiseparable\n";
+  for (int k : {1, 2})
+    for (int n = 250; n <= 1024000; n *= 2) {
+      Matrix ones(1, n, [](int, int) { return 1.0; });
+      auto S = Semiseparable::FromGenerator(k, n);
+      Matrix B = S * ones;
+      Matrix x(1, n);
+
+      std::cout << k << '\t' << n << '\t';
+      if (n <= 2000) {
+        Matrix A(n, [k, n](int i, int j) { return f(k, n, i, j); });
+        auto start = Clock::now();
+        MuteErrors mute;
+        Solver::Solve(A, B, x);
+        std::cout << Seconds(start);
+      } else {
+        std::cout << '-';
+      }
+
+      auto start = Clock::now();
+      {
+        MuteErrors mute;
+        Solver::Solve(S, B, x);
+      }
+      std::cout << '\t' << Seconds(start) << '\n';
+    }
+}
+
+template <class Pivot>
+void BenchPolicy(const char *name, const Matrix &A, const Matrix &B) {
+  MuteErrors mute;
+  Matrix x(1, A.rows());
+  try {
+    auto start = Clock::now();
+    Solver::Solve<Pivot>(A, B, x);
+    double seconds = Seconds(start);
+    auto report = Solver::Analyze<Pivot>(A, B);
+    std::cout << name << '\t' << seconds << '\t' << report.growth << '\t'
+              << report.residual << '\n';
+  } catch (std::exception &e) {
+    std::cout << name << '\t' << e.what() << '\n';
+  }
+}
+
+void BenchPivoting() {
+  const int n = 500;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  Matrix random(n, [&](int, int) { return dist(gen); });
+  Matrix dominant(n, [&](int i, int j) { return dist(gen) + (i == j) * n; });
+  Matrix distance(n, [n](int i, int j) { return f(3, n, i, j); });
+  Matrix B(1, n, [](int, int) { return 1.0; });
+
+  std::cout << "Pivoting policies, n = " << n << "\n";
+  for (auto input : {std::make_pair("random", &random),
+                     std::make_pair("dominant", &dominant),
+                     std::make_pair("distance", &distance)}) {
+    std::cout << input.first << "\tseconds\tgrowth\tresidual\n";
+    BenchPolicy<Solver::Pivoting::Full>("full", *input.second, B);
+    BenchPolicy<Solver::Pivoting::Rook>("rook", *input.second, B);
+    BenchPolicy<Solver::Pivoting::Partial>("partial", *input.second, B);
+    BenchPolicy<Solver::Pivoting::None>("none", *input.second, B);
+  }
+}
+
+void BenchSingular() {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  const int workers = std::max(1u, std::thread::hardware_concurrency());
+
+  std::cout << "Jacobi SVD, seconds\n";
+  std::cout << "n\tsweeps\tSVD(1)\tSVD(" << workers << ")\tcondition\n";
+  for (int n : {100, 200, 400}) {
+    Matrix A(n, [&](int, int) { return dist(gen); });
+    MuteErrors mute;
+    auto start = Clock::now();
+    SVD one(A, 1, false);
+    double serial = Seconds(start);
+    start = Clock::now();
+    SVD all(A, workers, false);
+    std::cout << n << '\t' << one.sweeps() << '\t' << serial << '\t'
+              << Seconds(start) << '\t' << all.condition() << '\n';
+  }
+}
+
+void BenchDistributed() {
+  const int n = 1000;
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  Matrix A(n, [&](int, int) { return dist(gen); });
+  Matrix B(1, n, [&](int, int) { return dist(gen); });
+  Matrix x(1, n);
+
+  std::cout << "Distributed solve, n = " << n << ", NUMA nodes "
+            << Solver::NumaNodes().size() << "\n";
+  std::cout << "processes\tseconds\tresidual\n";
+  MuteErrors mute;
+  auto start = Clock::now();
+  Solver::Solve<Solver::Pivoting::Partial>(A, B, x);
+  std::cout << "Solve\t" << Seconds(start) << '\t'
+            << Solver::Discrepancy(A, B, x) << '\n';
+  for (int processes : {1, 2, 4, 8}) {
+    start = Clock::now();
+    Solver::SolveDistributed(A, B, x, processes);
+    std::cout << processes << '\t' << Seconds(start) << '\t'
+              << Solver::Discrepancy(A, B, x) << '\n';
+  }
+}
+
+int main() {
+  BenchBatch();
+  BenchSemiseparable();
+  BenchPivoting();
+  BenchSingular();
+  BenchDistributed();
+  return 0;
+}
@@ -0,0 +1,209 @@
+#include "cache.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "solver.h"
+#include "symmetric.h"
+#include "toeplitz.h"
+#include "utils.h"
+
+constexpr uint64_t kMultiplier = 0x9E3779B97F4A7C15ull;
+
+uint64_t Mix(uint64_t h, uint64_t v) {
+  h = (h ^ v) * kMultiplier;
+  return h ^ (h >> 29);
+}
+
+uint64_t Bits(double value) {
+  // -0.0 and 0.0 are the same system
+  value += 0.0;
+  uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+uint64_t Hash(const Matrix &A) {
+  const int kStreams = 4;
+  uint64_t h[kStreams] = {1, 2, 3, 4};
+  const int cols = A.cols();
+  for (int j = 0; j < A.rows(); ++j) {
+    int i = 0;
+    for (; i + kStreams <= cols; i += kStreams)
+      for (int s = 0; s < kStreams; ++s) h[s] = Mix(h[s], Bits(A[{i + s, j}]));
+    for (; i < cols; ++i) h[0] = Mix(h[0], Bits(A[{i, j}]));
+  }
+  uint64_t result = Mix(A.cols(), A.rows());
+  for (int s = 0; s < kStreams; ++s) result = Mix(result, h[s]);
+  return result;
+}
+
+Cache::Cache(size_t capacity, std::string directory)
+    : _capacity(capacity), _directory(std::move(directory)) {
+  if (capacity < 1) throw std::domain_error("Cache error # 1");
+  if (!_directory.empty()) std::filesystem::create_directories(_directory);
+}
+
+Cache::Key Cache::SystemKey(const Matrix &A, const Matrix &b) {
+  return Mix(Mix(MatrixKey(A), Hash(b)), 1);
+}
+
+Cache::Key Cache::MatrixKey(const Matrix &A) { return Mix(Hash(A), 2); }
+
+Cache::Key Cache::GeneratorKey(int n, int k) {
+  return Mix(Mix(Mix(0, n), k), 3);
+}
+
+std::string Cache::path(Key key, const char *extension) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.%s",
+                static_cast<unsigned long long>(key), extension);
+  return (std::filesystem::path(_directory) / name).string();
+}
+
+// Reads an entry written by an earlier run, a damaged file is a miss
+template <class T, class Reader>
+std::shared_ptr<const T> Load(const std::string &path, Reader read) {
+  std::ifstream is(path, std::ios::binary);
+  if (!is) return nullptr;
+  try {
+    return std::make_shared<const T>(read(is));
+  } catch (std::runtime_error &) {
+    return nullptr;
+  }
+}
+
+Cache::Entry *Cache::find(Key key) {
+  auto it = _entries.find(key);
+  if (it == _entries.end()) return nullptr;
+  _order.splice(_order.begin(), _order, it->second.position);
+  return &it->second;
+}
+
+Cache::Entry &Cache::insert(Key key) {
+  if (Entry *entry = find(key)) return *entry;
+  if (_entries.size() == _capacity) {
+    _entries.erase(_order.back());
+    _order.pop_back();
+  }
+  _order.push_front(key);
+  Entry &entry = _entries[key];
+  entry.position = _order.begin();
+  return entry;
+}
+
+std::shared_ptr<const Matrix> Cache::solution(Key key) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  Entry *entry = find(key);
+  if (!entry || !entry->solution) {
+    std::shared_ptr<const Matrix> x;
+    if (!_directory.empty()) x = Load<Matrix>(path(key, "x"), ReadBinary);
+    if (!x) {
+      ++_misses;
+      return nullptr;
+    }
+    entry = &insert(key);
+    entry->solution = x;
+  }
+  ++_hits;
+  return entry->solution;
+}
+
+void Cache::store(Key key, const Matrix &x) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  insert(key).solution = std::make_shared<const Matrix>(x);
+  if (_directory.empty()) return;
+  std::ofstream os(path(key, "x"), std::ios::binary);
+  WriteBinary(os, x);
+}
+
+std::shared_ptr<const Factorization> Cache::factorization(Key key) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  Entry *entry = find(key);
+  if (!entry || !entry->factorization) {
+    std::shared_ptr<const Factorization> LU;
+    if (!_directory.empty())
+      LU = Load<Factorization>(path(key, "lu"), Factorization::Read);
+    if (!LU) {
+      ++_misses;
+      return nullptr;
+    }
+    entry = &insert(key);
+    entry->factorization = LU;
+  }
+  ++_hits;
+  return entry->factorization;
+}
+
+void Cache::store(Key key, std::shared_ptr<const Factorization> LU) {
+  std::lock_guard<std::mutex> lock(_mutex);
+  insert(key).factorization = LU;
+  if (_directory.empty()) return;
+  std::ofstream os(path(key, "lu"), std::ios::binary);
+  LU->write(os);
+}
+
+size_t Cache::size() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _entries.size();
+}
+
+long Cache::hits() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _hits;
+}
+
+long Cache::misses() const {
+  std::lock_guard<std::mutex> lock(_mutex);
+  return _misses;
+}
+
+// Residual below which a cached answer is taken as the solution
+bool Confirmed(const Matrix &A, const Matrix &B, const Matrix &x) {
+  return Solver::Discrepancy(A, B, x) <= 1e-8 * (B.norm() + 1);
+}
+
+void Solver::Solve(const Matrix &A, const Matrix &B, Matrix &x, Cache &cache) {
+  const int n = A.rows();
+  if (A.cols() != n || B.rows() != n)
+    throw std::runtime_error("Solver error # 2");
+
+  // A 64-bit key may collide, the residual check costs as much as the hash
+  const auto key = Cache::SystemKey(A, B);
+  if (auto stored = cache.solution(key)) {
+    if (stored->rows() == n && stored->cols() == B.cols() &&
+        Confirmed(A, B, *stored)) {
+      x = Matrix(*stored);
+      return;
+    }
+  }
+
+  // The same holds for a factorization stored under the key of A
+  const auto matrix_key = Cache::MatrixKey(A);
+  Matrix result(B);
+  if (auto LU = cache.factorization(matrix_key)) {
+    if (LU->size() == n) {
+      LU->solve(result);
+      if (Confirmed(A, B, result)) {
+        cache.store(key, result);
+        x = std::move(result);
+        return;
+      }
+    }
+  }
+
+  if (Toeplitz::Detect(A) || IsSymmetric(A)) {
+    Solve(A, B, result);
+  } else {
+    auto LU = std::make_shared<const Factorization>(A);
+    cache.store(matrix_key, LU);
+    result = B;
+    LU->solve(result);
+  }
+  cache.store(key, result);
+  x = std::move(result);
+}
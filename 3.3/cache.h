@@ -0,0 +1,69 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+#include "factorization.h"
+#include "matrix.h"
+
+// 64-bit hash of the shape and the elements of A. Four independent streams
+// run over consecutive elements and are merged at the end, so the loop has
+// no carried dependency between neighbours.
+uint64_t Hash(const Matrix &A);
+
+// Solutions and factorizations of recent systems, keyed by the contents of
+// (A, b) or by the parameters (n, k) of a generator. Beyond capacity the
+// least recently used entry is evicted. With a directory every entry is
+// also written there and read back on a miss, so it survives the process.
+class Cache {
+ public:
+  using Key = uint64_t;
+
+  explicit Cache(size_t capacity = 64, std::string directory = "");
+
+  static Key SystemKey(const Matrix &A, const Matrix &b);
+  static Key MatrixKey(const Matrix &A);
+  static Key GeneratorKey(int n, int k);
+
+  std::shared_ptr<const Matrix> solution(Key key);
+  void store(Key key, const Matrix &x);
+  std::shared_ptr<const Factorization> factorization(Key key);
+  void store(Key key, std::shared_ptr<const Factorization> LU);
+
+  size_t size() const;
+  long hits() const;
+  long misses() const;
+
+ private:
+  struct Entry {
+    std::list<Key>::iterator position;
+    std::shared_ptr<const Matrix> solution;
+    std::shared_ptr<const Factorization> factorization;
+  };
+
+  Entry *find(Key key);
+  Entry &insert(Key key);
+  std::string path(Key key, const char *extension) const;
+
+  size_t _capacity;
+  std::string _directory;
+  mutable std::mutex _mutex;
+  std::list<Key> _order;
+  std::unordered_map<Key, Entry> _entries;
+  long _hits{0};
+  long _misses{0};
+};
+
+namespace Solver {
+// Returns a stored solution of (A, b) if its residual confirms it, solves
+// with a stored factorization of A in O(n^2) otherwise, again kept only if
+// the residual confirms it. When neither is known, structured (Toeplitz or
+// symmetric) systems go to the dispatching Solve; the rest are factored
+// and both the factorization and the solution are stored. A singular A is
+// Solver error # 1 on every path.
+void Solve(const Matrix &A, const Matrix &b, Matrix &x, Cache &cache);
+}  // namespace Solver
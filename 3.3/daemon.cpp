@@ -0,0 +1,63 @@
+#include <csignal>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "matrix.h"
+#include "service.h"
+#include "utils.h"
+
+// daemon serve <socket> [workers]
+// daemon solve <socket> n m k
+int main(int argc, char *argv[]) {
+  if (argc < 3) throw std::runtime_error("Daemon error # 1");
+  const std::string mode = argv[1];
+  const std::string path = argv[2];
+
+  if (mode == "serve") {
+    const int workers = argc > 3 ? std::stoi(argv[3]) : 1;
+    // SIGINT and SIGTERM are taken by a thread, so the server stops cleanly
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    Server server(path, workers);
+    std::thread waiter([&server, &signals] {
+      int signal;
+      sigwait(&signals, &signal);
+      server.stop();
+    });
+    server.run();
+    pthread_kill(waiter.native_handle(), SIGTERM);
+    waiter.join();
+    std::cerr << "Factorizations reused: " << server.cache().hits() << '\n';
+    return 0;
+  }
+
+  if (mode != "solve" || argc != 6) throw std::runtime_error("Daemon error # 2");
+  const int n = std::stoi(argv[3]);
+  const int m = std::stoi(argv[4]);
+  const int k = std::stoi(argv[5]);
+
+  // The system is built directly in the shared segment
+  SharedSystem system(n, 1);
+  Matrix A = system.A();
+  Matrix B = system.b();
+  for (int j = 0; j < n; ++j) {
+    for (int i = 0; i < n; ++i) A[{i, j}] = f(k, n, i, j);
+    B[{0, j}] = 0;
+    for (int i = 0; i < n; i += 2) B[{0, j}] += A[{i, j}];
+  }
+  Client client(path);
+  const double error = client.solve(system);
+  Matrix x = system.x();
+
+  std::cout << "Solution is x = {";
+  for (int i = 0; i < m; ++i) std::cout << (i ? " " : "") << x.at(0, i);
+  std::cout << (m == n ? "}" : " ...}") << std::endl;
+  std::cout << "Error is " << error << std::endl;
+  return 0;
+}
@@ -0,0 +1,45 @@
+#include "ddouble.h"
+
+void AddScaled(double *y_hi, double *y_lo, const double *x_hi,
+               const double *x_lo, DDouble scale, int n) {
+  for (int i = 0; i < n; ++i) {
+    DDouble y = DDouble{y_hi[i], y_lo[i]} + DDouble{x_hi[i], x_lo[i]} * scale;
+    y_hi[i] = y.hi;
+    y_lo[i] = y.lo;
+  }
+}
+
+void Scale(double *x_hi, double *x_lo, DDouble scale, int n) {
+  for (int i = 0; i < n; ++i) {
+    DDouble x = DDouble{x_hi[i], x_lo[i]} * scale;
+    x_hi[i] = x.hi;
+    x_lo[i] = x.lo;
+  }
+}
+
+// Four independent partial sums break the dependency chain of the
+// accumulation, so the loop body can fill a vector register
+constexpr int kParts = 4;
+
+DDouble Dot(const double *a, const double *b, int n) {
+  DDouble sum[kParts] = {};
+  int i = 0;
+  for (; i + kParts <= n; i += kParts)
+    for (int k = 0; k < kParts; ++k)
+      sum[k] = sum[k] + TwoProd(a[i + k], b[i + k]);
+  for (; i < n; ++i) sum[0] = sum[0] + TwoProd(a[i], b[i]);
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
+
+DDouble Dot(const double *a_hi, const double *a_lo, const double *b_hi,
+            const double *b_lo, int n) {
+  DDouble sum[kParts] = {};
+  int i = 0;
+  for (; i + kParts <= n; i += kParts)
+    for (int k = 0; k < kParts; ++k)
+      sum[k] = sum[k] + DDouble{a_hi[i + k], a_lo[i + k]} *
+                            DDouble{b_hi[i + k], b_lo[i + k]};
+  for (; i < n; ++i)
+    sum[0] = sum[0] + DDouble{a_hi[i], a_lo[i]} * DDouble{b_hi[i], b_lo[i]};
+  return (sum[0] + sum[1]) + (sum[2] + sum[3]);
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cmath>
+
+// Unevaluated sum hi + lo of two doubles with |lo| <= ulp(hi) / 2, about
+// 106 bits of mantissa. Only plain double operations and fma are used, so
+// the element-wise kernels below vectorize like ordinary double loops.
+struct DDouble {
+  double hi;
+  double lo;
+};
+
+inline DDouble QuickTwoSum(double a, double b) {
+  double s = a + b;
+  return {s, b - (s - a)};
+}
+
+inline DDouble TwoSum(double a, double b) {
+  double s = a + b;
+  double v = s - a;
+  return {s, (a - (s - v)) + (b - v)};
+}
+
+inline DDouble TwoProd(double a, double b) {
+  double p = a * b;
+  return {p, std::fma(a, b, -p)};
+}
+
+inline DDouble operator+(DDouble a, DDouble b) {
+  DDouble s = TwoSum(a.hi, b.hi);
+  DDouble t = TwoSum(a.lo, b.lo);
+  s = QuickTwoSum(s.hi, s.lo + t.hi);
+  return QuickTwoSum(s.hi, s.lo + t.lo);
+}
+
+inline DDouble operator-(DDouble a) { return {-a.hi, -a.lo}; }
+inline DDouble operator-(DDouble a, DDouble b) { return a + -b; }
+
+inline DDouble operator*(DDouble a, DDouble b) {
+  DDouble p = TwoProd(a.hi, b.hi);
+  return QuickTwoSum(p.hi, p.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+
+inline DDouble operator*(DDouble a, double b) {
+  DDouble p = TwoProd(a.hi, b);
+  return QuickTwoSum(p.hi, p.lo + a.lo * b);
+}
+
+inline DDouble operator/(DDouble a, DDouble b) {
+  double q1 = a.hi / b.hi;
+  DDouble r = a - b * q1;
+  double q2 = r.hi / b.hi;
+  r = r - b * q2;
+  return QuickTwoSum(q1, q2) + DDouble{r.hi / b.hi, 0.0};
+}
+
+// Kernels on split storage: hi and lo parts live in separate arrays
+
+// y += scale * x
+void AddScaled(double *y_hi, double *y_lo, const double *x_hi,
+               const double *x_lo, DDouble scale, int n);
+// x *= scale
+void Scale(double *x_hi, double *x_lo, DDouble scale, int n);
+// sum a_i * b_i with exact products of plain doubles
+DDouble Dot(const double *a, const double *b, int n);
+// sum a_i * b_i
+DDouble Dot(const double *a_hi, const double *a_lo, const double *b_hi,
+            const double *b_lo, int n);
@@ -0,0 +1,287 @@
+#include "distributed.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "profiler.h"
+
+std::vector<std::vector<int>> Solver::NumaNodes() {
+  std::vector<std::vector<int>> nodes;
+  for (int node = 0;; ++node) {
+    std::ifstream is("/sys/devices/system/node/node" + std::to_string(node) +
+                     "/cpulist");
+    if (!is) break;
+    // "0-3,8-11"
+    std::vector<int> cpus;
+    std::string range;
+    while (std::getline(is, range, ',')) {
+      std::istringstream ss(range);
+      int first, last;
+      if (!(ss >> first)) continue;
+      last = first;
+      if (ss.get() == '-') ss >> last;
+      for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+    if (!cpus.empty()) nodes.push_back(cpus);
+  }
+  return nodes;
+}
+
+// Largest candidate of one process for the pivot of the current column
+struct Candidate {
+  double value;
+  int row;
+};
+
+// Start of the shared mapping, the matrix and the buffers follow it
+struct Shared {
+  pthread_barrier_t barrier;
+};
+
+// Number of the indices 0 .. total - 1 that fall into blocks of nb owned
+// by part p of parts, cyclically
+int LocalCount(int total, int nb, int parts, int p) {
+  int count = 0;
+  for (int b = p; b * nb < total; b += parts)
+    count += std::min(nb, total - b * nb);
+  return count;
+}
+
+// Position of index i among those of its owner
+int Local(int i, int nb, int parts) { return i / nb / parts * nb + i % nb; }
+
+// Everything a process needs to know about the distribution. The blocks of
+// every process are stored together, row-major in a region of whole pages
+// of their own, so a page is only ever touched by its owner.
+struct Layout {
+  int n;
+  int w;
+  int nb;
+  int rows;
+  int cols;
+  double *blocks;
+  // Offset of the region of each rank in blocks, row length per grid column
+  std::vector<size_t> region;
+  std::vector<int> local_cols;
+  double *pivot_row;
+  double *multipliers;
+  Candidate *candidates;
+
+  int row_owner(int j) const { return j / nb % rows; }
+  int col_owner(int c) const { return c / nb % cols; }
+  double &at(int c, int j) const {
+    const int pc = col_owner(c);
+    return blocks[region[row_owner(j) * cols + pc] +
+                  static_cast<size_t>(Local(j, nb, rows)) * local_cols[pc] +
+                  Local(c, nb, cols)];
+  }
+};
+
+// Elimination on the blocks of process (pr, pc). Returns false if the
+// matrix is singular; all processes see the same candidates, so they
+// agree on it and leave together.
+bool Eliminate(const Layout &L, pthread_barrier_t *barrier, int pr, int pc) {
+  const int n = L.n;
+  const int rank = pr * L.cols + pc;
+  auto mine = [&L, pr, pc](int c, int j) {
+    return L.row_owner(j) == pr && L.col_owner(c) == pc;
+  };
+
+  for (int i = 0; i < n; ++i) {
+    // Partial pivot: every owner of column i searches its rows
+    Candidate best{-1.0, -1};
+    if (L.col_owner(i) == pc)
+      for (int j = i; j < n; ++j)
+        if (L.row_owner(j) == pr && std::abs(L.at(i, j)) > best.value)
+          best = {std::abs(L.at(i, j)), j};
+    L.candidates[rank] = best;
+    pthread_barrier_wait(barrier);
+
+    best = {-1.0, -1};
+    for (int p = 0; p < L.rows * L.cols; ++p) {
+      const Candidate &c = L.candidates[p];
+      if (c.value > best.value || (c.value == best.value && c.row < best.row))
+        best = c;
+    }
+    if (best.value < 1e-14) return false;
+
+    // One process per column block swaps rows i and best.row
+    const int r = best.row;
+    if (r != i && L.row_owner(i) == pr)
+      for (int c = i; c < L.w; ++c)
+        if (L.col_owner(c) == pc) std::swap(L.at(c, i), L.at(c, r));
+    pthread_barrier_wait(barrier);
+
+    // The pivot row and the multipliers are published for everyone
+    const double pivot = L.at(i, i);
+    for (int c = i + 1; c < L.w; ++c)
+      if (mine(c, i)) {
+        L.pivot_row[c] = L.at(c, i) / pivot;
+        L.at(c, i) = L.pivot_row[c];
+      }
+    for (int j = i + 1; j < n; ++j)
+      if (mine(i, j)) {
+        L.multipliers[j] = L.at(i, j);
+        L.at(i, j) = 0;
+      }
+    pthread_barrier_wait(barrier);
+    if (mine(i, i)) L.at(i, i) = 1;
+
+    // Trailing update, block by block
+    for (int j0 = (i + 1) / L.nb * L.nb; j0 < n; j0 += L.nb) {
+      if (L.row_owner(j0) != pr) continue;
+      for (int c0 = (i + 1) / L.nb * L.nb; c0 < L.w; c0 += L.nb) {
+        if (L.col_owner(c0) != pc) continue;
+        const int c_begin = std::max(c0, i + 1);
+        const int c_end = std::min(c0 + L.nb, L.w);
+        // Columns of one block are contiguous in the region
+        for (int j = std::max(j0, i + 1); j < std::min(j0 + L.nb, n); ++j) {
+          const double l = L.multipliers[j];
+          double *row = &L.at(c_begin, j) - c_begin;
+          for (int c = c_begin; c < c_end; ++c) row[c] -= l * L.pivot_row[c];
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Rows of a near-square grid of p processes, not fewer than its columns
+int GridRows(int p) {
+  int cols = 1;
+  for (int d = 1; d * d <= p; ++d)
+    if (p % d == 0) cols = d;
+  return p / cols;
+}
+
+void Solver::SolveDistributed(const Matrix &A, const Matrix &B, Matrix &x,
+                              int processes, int block) {
+  const int n = A.rows();
+  const int k = B.cols();
+  if (A.cols() != n || B.rows() != n)
+    throw std::runtime_error("Solver error # 2");
+  if (processes < 1 || block < 1) throw std::runtime_error("Solver error # 6");
+
+  LOG_DURATION("Algorithm distributed time");
+  const int w = n + k;
+  Layout L;
+  L.n = n;
+  L.w = w;
+  L.nb = block;
+  L.rows = GridRows(processes);
+  L.cols = processes / L.rows;
+
+  // The barrier, candidates and buffers, then the regions, all in pages
+  const size_t page = sysconf(_SC_PAGESIZE);
+  auto pages = [page](size_t size) { return (size + page - 1) / page * page; };
+  size_t bytes = pages(sizeof(Shared) + sizeof(Candidate) * processes +
+                       sizeof(double) * (w + n));
+  const size_t head = bytes;
+  for (int pc = 0; pc < L.cols; ++pc)
+    L.local_cols.push_back(LocalCount(w, block, L.cols, pc));
+  for (int rank = 0; rank < processes; ++rank) {
+    L.region.push_back((bytes - head) / sizeof(double));
+    const size_t local_rows = LocalCount(n, block, L.rows, rank / L.cols);
+    bytes += pages(sizeof(double) * local_rows * L.local_cols[rank % L.cols]);
+  }
+  void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) throw std::runtime_error("Solver error # 11");
+
+  auto *shared = static_cast<Shared *>(memory);
+  L.candidates = reinterpret_cast<Candidate *>(shared + 1);
+  L.pivot_row = reinterpret_cast<double *>(L.candidates + processes);
+  L.multipliers = L.pivot_row + w;
+  L.blocks = reinterpret_cast<double *>(static_cast<char *>(memory) + head);
+
+  pthread_barrierattr_t attributes;
+  pthread_barrierattr_init(&attributes);
+  pthread_barrierattr_setpshared(&attributes, PTHREAD_PROCESS_SHARED);
+  pthread_barrier_init(&shared->barrier, &attributes, processes);
+  pthread_barrierattr_destroy(&attributes);
+
+  const auto nodes = NumaNodes();
+  std::vector<pid_t> children;
+  for (int rank = 0; rank < processes; ++rank) {
+    pid_t pid = fork();
+    if (pid < 0) break;
+    if (pid > 0) {
+      children.push_back(pid);
+      continue;
+    }
+
+    if (!nodes.empty()) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      for (int cpu : nodes[rank % nodes.size()]) CPU_SET(cpu, &set);
+      sched_setaffinity(0, sizeof(set), &set);
+    }
+    const int pr = rank / L.cols;
+    const int pc = rank % L.cols;
+    // First touch of the own blocks happens on the node of this process
+    for (int j = 0; j < n; ++j) {
+      if (L.row_owner(j) != pr) continue;
+      for (int c = 0; c < w; ++c)
+        if (L.col_owner(c) == pc)
+          L.at(c, j) = c < n ? A[{c, j}] : B[{c - n, j}];
+    }
+    pthread_barrier_wait(&shared->barrier);
+    _exit(Eliminate(L, &shared->barrier, pr, pc) ? 0 : 1);
+  }
+
+  // A process that failed to start or died would leave the others waiting
+  // at a barrier forever, so they are killed. Only the recorded ranks are
+  // waited for, other children of the caller keep their exit statuses; they
+  // are polled since any of them may be the first to end.
+  bool singular = false;
+  bool failed = static_cast<int>(children.size()) != processes;
+  while (!children.empty()) {
+    if (failed)
+      for (pid_t pid : children) kill(pid, SIGKILL);
+    bool reaped = false;
+    for (size_t c = 0; c < children.size();) {
+      int status;
+      pid_t pid = waitpid(children[c], &status, WNOHANG);
+      if (pid == 0) {
+        ++c;
+        continue;
+      }
+      children.erase(children.begin() + c);
+      reaped = true;
+      if (pid < 0 || !WIFEXITED(status) || WEXITSTATUS(status) > 1)
+        failed = true;
+      else if (WEXITSTATUS(status) == 1)
+        singular = true;
+    }
+    if (!reaped && !children.empty())
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+
+  Matrix result(k, n);
+  if (!singular && !failed)
+    for (int c = 0; c < k; ++c)
+      for (int i = n - 1; i >= 0; --i) {
+        double s = L.at(n + c, i);
+        for (int p = i + 1; p < n; ++p) s -= L.at(p, i) * result[{c, p}];
+        result[{c, i}] = s;
+      }
+  pthread_barrier_destroy(&shared->barrier);
+  munmap(memory, bytes);
+  if (failed) throw std::runtime_error("Solver error # 11");
+  if (singular) throw std::runtime_error("Solver error # 1");
+  x = std::move(result);
+}
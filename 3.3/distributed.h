@@ -0,0 +1,20 @@
+#pragma once
+#include <vector>
+
+#include "matrix.h"
+
+namespace Solver {
+// CPU lists of the NUMA nodes from /sys, empty if the system has none
+std::vector<std::vector<int>> NumaNodes();
+
+// Gauss elimination with partial pivoting shared by `processes` forked
+// processes, each pinned to a NUMA node in turn. [A | B] is distributed 2D
+// block-cyclically in blocks of `block` x `block` over a near-square grid
+// of processes. The blocks of each process are stored together in pages of
+// their own within a shared mapping, and only that process copies in and
+// updates them, so their pages are first touched on its node. The pivot row
+// and the multiplier column of each step go through shared buffers between
+// barriers. Back substitution runs in the caller.
+void SolveDistributed(const Matrix &A, const Matrix &b, Matrix &x,
+                      int processes, int block = 32);
+}  // namespace Solver
@@ -0,0 +1,83 @@
+#include "factorization.h"
+
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "profiler.h"
+#include "solver.h"
+#include "utils.h"
+
+Factorization::Factorization(const Matrix &A)
+    : _LU(A), _rows(A.rows()), _cols(A.cols()) {
+  const int n = A.rows();
+  if (A.cols() != n) throw std::runtime_error("Factorization error # 1");
+
+  LOG_DURATION("LU decomposition time");
+  std::iota(_rows.begin(), _rows.end(), 0);
+  std::iota(_cols.begin(), _cols.end(), 0);
+  for (int i = 0; i < n; ++i) {
+    // The pivot and the singularity test of the direct pass
+    const Index max = Solver::Pivoting::Full::Find(_LU, i);
+    if (std::abs(_LU[max]) < 1e-14)
+      throw std::runtime_error("Solver error # 1");
+
+    _LU.swap(i, max.row, 'r');
+    std::swap(_rows[i], _rows[max.row]);
+    _LU.swap(i, max.col, 'c');
+    std::swap(_cols[i], _cols[max.col]);
+
+    if (i + 1 == n) break;
+    const double pivot = _LU[{i, i}];
+    auto U = _LU.submat({i + 1, i}, {n - 1, i});
+    for (int j = i + 1; j < n; ++j) {
+      double &l = _LU[{i, j}];
+      l /= pivot;
+      _LU.submat({i + 1, j}, {n - 1, j}).add_scaled(U, -l);
+    }
+  }
+}
+
+int Factorization::size() const { return _LU.rows(); }
+
+void Factorization::solve(Matrix &B) const {
+  const int n = size();
+  if (B.rows() != n) throw std::runtime_error("Factorization error # 3");
+  std::vector<double> y(n);
+  for (int c = 0; c < B.cols(); ++c) {
+    for (int i = 0; i < n; ++i) {
+      double s = B[{c, _rows[i]}];
+      for (int p = 0; p < i; ++p) s -= _LU[{p, i}] * y[p];
+      y[i] = s;
+    }
+    for (int i = n - 1; i >= 0; --i) {
+      double s = y[i];
+      for (int p = i + 1; p < n; ++p) s -= _LU[{p, i}] * y[p];
+      y[i] = s / _LU[{i, i}];
+    }
+    for (int i = 0; i < n; ++i) B[{c, _cols[i]}] = y[i];
+  }
+}
+
+void Factorization::write(std::ostream &os) const {
+  WriteBinary(os, _LU);
+  os.write(reinterpret_cast<const char *>(_rows.data()),
+           sizeof(int) * _rows.size());
+  os.write(reinterpret_cast<const char *>(_cols.data()),
+           sizeof(int) * _cols.size());
+  if (!os.good()) throw std::runtime_error("Factorization error # 4");
+}
+
+Factorization Factorization::Read(std::istream &is) {
+  Factorization result;
+  result._LU = ReadBinary(is);
+  const int n = result._LU.rows();
+  if (result._LU.cols() != n)
+    throw std::runtime_error("Factorization error # 5");
+  result._rows.resize(n);
+  result._cols.resize(n);
+  is.read(reinterpret_cast<char *>(result._rows.data()), sizeof(int) * n);
+  is.read(reinterpret_cast<char *>(result._cols.data()), sizeof(int) * n);
+  if (!is.good()) throw std::runtime_error("Factorization error # 5");
+  return result;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "matrix.h"
+
+// P A Q = L U with full pivoting. L has a unit diagonal and shares one
+// matrix with U. Once built, every new right-hand side costs O(n^2). The
+// pivots are those of Solver::Direct<Pivoting::Full>, which folds the
+// multipliers into B instead of keeping them, so the elimination itself is
+// repeated here. A singular A is Solver error # 1.
+class Factorization {
+ public:
+  explicit Factorization(const Matrix &A);
+
+  int size() const;
+  // B is replaced by A^-1 B
+  void solve(Matrix &B) const;
+
+  // Binary form, read back without repeating the O(n^3) elimination
+  void write(std::ostream &os) const;
+  static Factorization Read(std::istream &is);
+
+ private:
+  Factorization() = default;
+
+  Matrix _LU;
+  std::vector<int> _rows;
+  std::vector<int> _cols;
+};
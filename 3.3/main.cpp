@@ -1,8 +1,13 @@
+#include <cstdlib>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <optional>
 #include <stdexcept>
 
+#include "cache.h"
 #include "matrix.h"
+#include "semiseparable.h"
 #include "solver.h"
 #include "utils.h"
 
@@ -15,23 +20,56 @@ int main(int argc, char *argv[]) {
   m = std::stoi(argv[2]);
   k = std::stoi(argv[3]);
 
-  if (k == 0) {
-    if (argc != 4) throw std::runtime_error("Main error # 2");
-    std::ifstream ifs(argv[4]);
-    A = std::move(ReadMatrix(ifs, n));
+  // Solutions are kept between runs in the directory named by SOLVER_CACHE
+  std::optional<Cache> cache;
+  if (const char *directory = std::getenv("SOLVER_CACHE"))
+    cache.emplace(64, directory);
+
+  std::future<double> error;
+  std::optional<Semiseparable> S;
+  if (k == 1 || k == 2) {
+    // These generators are solved in O(n) without building the matrix
+    S = Semiseparable::FromGenerator(k, n);
+    x = std::move(Matrix(1, n));
+    B = *S * Matrix(1, n, [](int, int j) { return j % 2 == 0 ? 1.0 : 0.0; });
+    Solver::Solve(*S, B, x);
+    error = std::async(std::launch::async,
+                       [&] { return Solver::Discrepancy(*S, B, x); });
   } else {
-    A = std::move(Matrix(n, [k, n](int i, int j) { return f(k, n, i, j); }));
-  }
-  x = std::move(Matrix(1, n));
-  B = std::move(Matrix(1, n));
-  for (int i = 0; i < n; i += 2) B += A.col(i);
+    if (k == 0) {
+      if (argc != 4) throw std::runtime_error("Main error # 2");
+      std::ifstream ifs(argv[4]);
+      A = std::move(ReadMatrix(ifs, n));
+    } else {
+      A = std::move(Matrix(n, [k, n](int i, int j) { return f(k, n, i, j); }));
+    }
+    x = std::move(Matrix(1, n));
+    B = std::move(Matrix(1, n));
+    for (int i = 0; i < n; i += 2) B += A.col(i);
+
+    if (cache && k != 0) {
+      // B depends on (n, k) only, so the generator is the whole key
+      const auto key = Cache::GeneratorKey(n, k);
+      if (auto stored = cache->solution(key)) {
+        x = Matrix(*stored);
+      } else {
+        Solver::Solve(A, B, x);
+        cache->store(key, x);
+      }
+    } else if (cache) {
+      Solver::Solve(A, B, x, *cache);
+    } else {
+      Solver::Solve(A, B, x);
+    }
 
-  Solver::Solve(A, B, x);
-  double error = Solver::Discrepancy(A, B, x);
+    for(int w : {1, 2, 4}){
+      std::cerr << "workers = " << w << '\n';
+      Solver::Async::Discrepancy(A, B, x, w);
+    }
 
-  for(int w : {1, 2, 4}){
-    std::cerr << "workers = " << w << '\n';
-    Solver::Async::Discrepancy(A, B, x, w);
+    // The residual is computed while the solution is being printed
+    error = std::async(std::launch::async,
+                       [&] { return Solver::Discrepancy(A, B, x); });
   }
 
   std::cout << "Solution is x = {";
@@ -42,6 +80,6 @@ int main(int argc, char *argv[]) {
     std::cout << x.at(0, i);
   }
   std::cout << (m == n ? "}" : " ...}") << std::endl;
-  std::cout << "Error is " << error << std::endl;
+  std::cout << "Error is " << error.get() << std::endl;
   return 0;
 }
\ No newline at end of file
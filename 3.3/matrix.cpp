@@ -5,6 +5,8 @@
 #include <stdexcept>
 #include <vector>
 
+std::atomic<long> Matrix::_allocations{0};
+
 bool Index::operator==(const Index &other) const {
   return col == other.col && row == other.row;
 }
@@ -17,14 +19,19 @@ Matrix::Matrix(int cols, int rows, int step)
   if (cols < 1 || rows < 1) throw std::domain_error("Matix error # 1");
 }
 
-Matrix::Matrix(int N) : Matrix(N, N, N) { _data = new double[N * N](); }
+Matrix::Matrix(int N) : Matrix(N, N, N) {
+  _data = new double[N * N]();
+  ++_allocations;
+}
 
 Matrix::Matrix(int cols, int rows) : Matrix(cols, rows, cols) {
   _data = new double[cols * rows]();
+  ++_allocations;
 }
 
 Matrix::Matrix(int N, Initializer func) : Matrix(N, N, N) {
   _data = new double[N * N];
+  ++_allocations;
   double *p = _data;
   for (int j = 0; j < _rows; ++j) {
     for (int i = 0; i < _cols; ++i) p[i] = func(i, j);
@@ -35,6 +42,7 @@ Matrix::Matrix(int N, Initializer func) : Matrix(N, N, N) {
 Matrix::Matrix(int cols, int rows, Initializer func)
     : Matrix(cols, rows, cols) {
   _data = new double[cols * rows];
+  ++_allocations;
   double *p = _data;
   for (int j = 0; j < _rows; ++j) {
     for (int i = 0; i < _cols; ++i) p[i] = func(i, j);
@@ -49,6 +57,7 @@ Matrix::Matrix(int cols, int rows, double *data) : Matrix(cols, rows, cols) {
 Matrix::Matrix(const Matrix &other)
     : Matrix(other._cols, other._rows, other._cols) {
   _data = new double[other._cols * other._rows];
+  ++_allocations;
   double *pt = _data;
   double *po = other._data;
   for (int j = 0; j < _rows; ++j) {
@@ -189,6 +198,7 @@ Matrix &Matrix::operator=(const Matrix &other) {
     if (_cols * _rows != other._cols * other._rows) {
       delete _data;
       _data = new double[other._cols * other._rows];
+      ++_allocations;
     }
     double *pt = _data;
     double *po = other._data;
@@ -298,6 +308,8 @@ double Matrix::norm() const {
 
 void Matrix::release() { _reference = true; }
 
+long Matrix::allocations() { return _allocations; }
+
 std::ostream &operator<<(std::ostream &os, const Matrix &M) {
   for (int j = 0; j < M.rows(); ++j) {
     for (int i = 0; i < M.cols(); ++i) os << M[{i, j}] << ' ';
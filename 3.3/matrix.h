@@ -1,4 +1,5 @@
 #pragma once
+#include <atomic>
 #include <functional>
 #include <ostream>
 #include <utility>
@@ -66,6 +67,8 @@ class Matrix {
   void swap(int i, int j, char what);
   double norm() const;
   void release();
+  // Buffers allocated by all matrices so far, views are not counted
+  static long allocations();
 
  private:
   Matrix(int cols, int rows, int step);
@@ -76,6 +79,7 @@ class Matrix {
   int _rows;
   int _step;
   bool _reference{false};
+  static std::atomic<long> _allocations;
 };
 
 std::ostream &operator<<(std::ostream &os, const Matrix &M);
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+// Runs f(0) ... f(workers - 1) concurrently, f(0) on the calling thread
+template <class Func>
+void Parallel(int workers, Func f) {
+  if (workers < 1) throw std::runtime_error("Parallel error # 1");
+  std::vector<std::future<void>> futures;
+  futures.reserve(workers - 1);
+  for (int w = 1; w < workers; ++w)
+    futures.push_back(std::async(std::launch::async, f, w));
+  f(0);
+  for (auto &future : futures) future.get();
+}
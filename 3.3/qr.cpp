@@ -0,0 +1,200 @@
+#include "qr.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "parallel.h"
+#include "profiler.h"
+
+// Turns column j below the diagonal into a Householder vector v with an
+// implicit unit at row j, so that (I - tau v v^T) a_j = beta e_j. Returns tau.
+double Reflector(Matrix &A, int j) {
+  const int m = A.rows();
+  const double x = A[{j, j}];
+  double sigma = 0;
+  for (int i = j + 1; i < m; ++i) sigma += A[{j, i}] * A[{j, i}];
+  if (sigma == 0) return 0;
+
+  const double beta = -std::copysign(sqrt(x * x + sigma), x);
+  const double scale = 1 / (x - beta);
+  for (int i = j + 1; i < m; ++i) A[{j, i}] *= scale;
+  A[{j, j}] = beta;
+  return (beta - x) / beta;
+}
+
+// Applies reflector j of V to the columns c0 .. c1 - 1 of B
+void ApplyReflector(const Matrix &V, int j, double tau, Matrix &B, int c0,
+                    int c1) {
+  if (tau == 0 || c0 >= c1) return;
+  std::vector<double> w(c1);
+  for (int c = c0; c < c1; ++c) w[c] = B[{c, j}];
+  for (int i = j + 1; i < B.rows(); ++i) {
+    const double v = V[{j, i}];
+    const double *row = &B[{0, i}];
+    for (int c = c0; c < c1; ++c) w[c] += v * row[c];
+  }
+  for (int c = c0; c < c1; ++c) B[{c, j}] -= tau * w[c];
+  for (int i = j + 1; i < B.rows(); ++i) {
+    const double v = tau * V[{j, i}];
+    double *row = &B[{0, i}];
+    for (int c = c0; c < c1; ++c) row[c] -= v * w[c];
+  }
+}
+
+// A[k0.., k1..] = (I - Y T Y^T)^T A[k0.., k1..] for the reflectors of the
+// columns k0 .. k1 - 1. The columns are shared among the workers.
+void UpdateTrailing(Matrix &A, const std::vector<double> &tau, int k0, int k1,
+                    int workers) {
+  const int m = A.rows();
+  const int n = A.cols();
+  const int nb = k1 - k0;
+  auto y = [&A, k0](int i, int p) {
+    const int j = k0 + p;
+    return i < j ? 0.0 : i == j ? 1.0 : A[{j, i}];
+  };
+
+  // Upper triangular T of the compact WY form
+  std::vector<double> T(nb * nb, 0.0);
+  std::vector<double> z(nb);
+  for (int p = 0; p < nb; ++p) {
+    T[p * nb + p] = tau[k0 + p];
+    std::fill(z.begin(), z.end(), 0.0);
+    for (int i = k0 + p; i < m; ++i) {
+      const double yp = y(i, p);
+      for (int q = 0; q < p; ++q) z[q] += y(i, q) * yp;
+    }
+    for (int q = 0; q < p; ++q) {
+      double s = 0;
+      for (int r = q; r < p; ++r) s += T[q * nb + r] * z[r];
+      T[q * nb + p] = -tau[k0 + p] * s;
+    }
+  }
+
+  const int width = n - k1;
+  const int step = (width + workers - 1) / workers;
+  Parallel(workers, [&](int w) {
+    const int c0 = k1 + w * step;
+    const int c1 = std::min(c0 + step, n);
+    if (c0 >= c1) return;
+    // W = Y^T C, W = T^T W, C -= Y W
+    std::vector<double> W(nb * (c1 - c0), 0.0);
+    auto Wp = [&W, c0, c1](int p) { return W.data() + p * (c1 - c0) - c0; };
+    for (int i = k0; i < m; ++i) {
+      const double *row = &A[{0, i}];
+      for (int p = 0; p < std::min(nb, i - k0 + 1); ++p) {
+        const double yp = y(i, p);
+        double *wp = Wp(p);
+        for (int c = c0; c < c1; ++c) wp[c] += yp * row[c];
+      }
+    }
+    for (int p = nb - 1; p >= 0; --p) {
+      double *wp = Wp(p);
+      for (int c = c0; c < c1; ++c) wp[c] *= T[p * nb + p];
+      for (int q = 0; q < p; ++q) {
+        const double t = T[q * nb + p];
+        const double *wq = Wp(q);
+        for (int c = c0; c < c1; ++c) wp[c] += t * wq[c];
+      }
+    }
+    for (int i = k0; i < m; ++i) {
+      double *row = &A[{0, i}];
+      for (int p = 0; p < std::min(nb, i - k0 + 1); ++p) {
+        const double yp = y(i, p);
+        const double *wp = Wp(p);
+        for (int c = c0; c < c1; ++c) row[c] -= yp * wp[c];
+      }
+    }
+  });
+}
+
+QR::QR(const Matrix &A, int block, int workers)
+    : _QR(A), _tau(A.cols()) {
+  const int m = rows();
+  const int n = cols();
+  if (m < n) throw std::domain_error("QR error # 1");
+  if (block < 1 || workers < 1) throw std::domain_error("QR error # 2");
+
+  LOG_DURATION("QR decomposition time");
+  for (int k0 = 0; k0 < n; k0 += block) {
+    const int k1 = std::min(k0 + block, n);
+    for (int j = k0; j < k1; ++j) {
+      _tau[j] = Reflector(_QR, j);
+      ApplyReflector(_QR, j, _tau[j], _QR, j + 1, k1);
+    }
+    if (k1 < n) UpdateTrailing(_QR, _tau, k0, k1, workers);
+  }
+}
+
+int QR::rows() const { return _QR.rows(); }
+int QR::cols() const { return _QR.cols(); }
+
+Matrix QR::R() const {
+  return Matrix(cols(), [this](int i, int j) {
+    return i >= j ? _QR[{i, j}] : 0.0;
+  });
+}
+
+void QR::apply_qt(Matrix &B) const {
+  if (B.rows() != rows()) throw std::domain_error("QR error # 3");
+  for (int j = 0; j < cols(); ++j)
+    ApplyReflector(_QR, j, _tau[j], B, 0, B.cols());
+}
+
+// x = R^-1 C for the leading triangle of R and the columns c0 ... of C
+void BackSubstitute(const Matrix &R, const Matrix &C, int c0, Matrix &x) {
+  const int n = x.rows();
+  double max = 0;
+  for (int i = 0; i < n; ++i) max = std::max(max, std::abs(R[{i, i}]));
+  for (int i = 0; i < n; ++i)
+    if (std::abs(R[{i, i}]) <= 1e-14 * max)
+      throw std::runtime_error("Solver error # 9");
+
+  for (int c = 0; c < x.cols(); ++c)
+    for (int i = n - 1; i >= 0; --i) {
+      double s = C[{c0 + c, i}];
+      for (int p = i + 1; p < n; ++p) s -= R[{p, i}] * x[{c, p}];
+      x[{c, i}] = s / R[{i, i}];
+    }
+}
+
+double Solver::LeastSquares(const Matrix &A, const Matrix &B, Matrix &x,
+                            int workers) {
+  const int m = A.rows();
+  const int n = A.cols();
+  const int k = B.cols();
+  if (B.rows() != m || m < n) throw std::runtime_error("Solver error # 2");
+  if (workers < 1) throw std::runtime_error("Solver error # 6");
+
+  LOG_DURATION("Least squares time");
+  Matrix result(k, n);
+  const int w = n + k;
+  // Row blocks are kept at least twice as tall as they are wide
+  const int parts = std::min(workers, m / (2 * w));
+  if (parts < 2) {
+    // Too short for row blocks, the workers share the trailing updates
+    QR qr(A, 32, workers);
+    Matrix QtB(B);
+    qr.apply_qt(QtB);
+    BackSubstitute(qr.R(), QtB, 0, result);
+    x = std::move(result);
+    if (m == n) return 0;
+    return QtB.submat({0, n}, {k - 1, m - 1}).norm();
+  }
+
+  // TSQR: the R factor of [A | B] is the R factor of the stacked R factors
+  // of its row blocks
+  Matrix stacked(w, parts * w);
+  Parallel(parts, [&](int p) {
+    const int first = m / parts * p;
+    const int last = p + 1 == parts ? m : m / parts * (p + 1);
+    Matrix block(w, last - first, [&](int i, int j) {
+      return i < n ? A[{i, first + j}] : B[{i - n, first + j}];
+    });
+    Matrix R = QR(block).R();
+    stacked.submat({0, p * w}, {w - 1, p * w + w - 1}) += R;
+  });
+  Matrix R = QR(stacked, 32, workers).R();
+  BackSubstitute(R, R, n, result);
+  x = std::move(result);
+  return R.submat({n, n}, {w - 1, w - 1}).norm();
+}
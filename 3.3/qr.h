@@ -0,0 +1,32 @@
+#pragma once
+#include <vector>
+
+#include "matrix.h"
+
+// Householder QR of an m x n matrix, m >= n. Reflectors are produced in
+// panels of `block` columns and applied to the rest of the matrix in the
+// compact WY form I - Y T Y^T, so most of the work is matrix products.
+// R is kept in the upper triangle, the reflectors below the diagonal.
+class QR {
+ public:
+  explicit QR(const Matrix &A, int block = 32, int workers = 1);
+
+  int rows() const;
+  int cols() const;
+  Matrix R() const;
+  // B = Q^T B
+  void apply_qt(Matrix &B) const;
+
+ private:
+  Matrix _QR;
+  std::vector<double> _tau;
+};
+
+namespace Solver {
+// Minimizes |A x - B| for an overdetermined A and returns the residual
+// norm. With several workers tall matrices are split into row blocks that
+// are factored independently (TSQR), and their R factors are merged; other
+// matrices share the blocked trailing updates of one QR among the workers.
+double LeastSquares(const Matrix &A, const Matrix &b, Matrix &x,
+                    int workers = 1);
+}  // namespace Solver
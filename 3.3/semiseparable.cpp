@@ -0,0 +1,81 @@
+#include "semiseparable.h"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "profiler.h"
+#include "utils.h"
+
+Semiseparable::Semiseparable(std::vector<double> g) : _g(std::move(g)) {
+  if (_g.empty()) throw std::domain_error("Semiseparable error # 1");
+}
+
+Semiseparable Semiseparable::FromGenerator(int k, int n) {
+  if (k != 1 && k != 2) throw std::domain_error("Semiseparable error # 2");
+  std::vector<double> g(n);
+  for (int i = 0; i < n; ++i) g[i] = f(k, n, i, i);
+  return Semiseparable(std::move(g));
+}
+
+int Semiseparable::size() const { return _g.size(); }
+
+double Semiseparable::at(int col, int row) const {
+  if (col < 0 || col >= size() || row < 0 || row >= size())
+    throw std::range_error("Semiseparable error # 3");
+  return _g[std::max(col, row)];
+}
+
+Matrix Semiseparable::operator*(const Matrix &x) const {
+  const int n = size();
+  if (x.rows() != n) throw std::domain_error("Semiseparable error # 4");
+  // (A x)_i = g_i * sum_{j <= i} x_j + sum_{j > i} g_j x_j
+  Matrix result(x.cols(), n);
+  for (int c = 0; c < x.cols(); ++c) {
+    double suffix = 0;
+    for (int i = n - 1; i >= 0; --i) {
+      result[{c, i}] = suffix;
+      suffix += _g[i] * x[{c, i}];
+    }
+    double prefix = 0;
+    for (int i = 0; i < n; ++i) {
+      prefix += x[{c, i}];
+      result[{c, i}] += _g[i] * prefix;
+    }
+  }
+  return result;
+}
+
+void Solver::Solve(const Semiseparable &A, const Matrix &B, Matrix &x) {
+  const int n = A.size();
+  if (B.rows() != n || x.rows() != n)
+    throw std::runtime_error("Solver error # 2");
+
+  LOG_DURATION("Algorithm semiseparable time");
+  double max = 0;
+  for (int i = 0; i < n; ++i) max = std::max(max, std::abs(A.at(i, i)));
+
+  // Row i minus row i + 1 is (g_i - g_(i+1)) (1, ..., 1, 0, ..., 0), so it
+  // gives the prefix sum s_i = x_0 + ... + x_i directly
+  Matrix result(B.cols(), n);
+  for (int c = 0; c < B.cols(); ++c) {
+    double previous = 0;
+    for (int i = 0; i < n; ++i) {
+      const double d = i + 1 < n ? A.at(i, i) - A.at(i + 1, i + 1) : A.at(i, i);
+      if (std::abs(d) < 1e-14 * max)
+        throw std::runtime_error("Solver error # 8");
+      const double r = i + 1 < n ? B[{c, i}] - B[{c, i + 1}] : B[{c, i}];
+      const double s = r / d;
+      result[{c, i}] = s - previous;
+      previous = s;
+    }
+  }
+  x = std::move(result);
+}
+
+double Solver::Discrepancy(const Semiseparable &A, const Matrix &B,
+                           const Matrix &x) {
+  LOG_DURATION("Error calculation time");
+  Matrix result = A * x;
+  result -= B;
+  return result.norm();
+}
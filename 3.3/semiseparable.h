@@ -0,0 +1,27 @@
+#pragma once
+#include <vector>
+
+#include "matrix.h"
+
+// Matrix with a(col, row) = g(max(col, row)), as produced by the generators
+// k = 1 and k = 2 of utils.cpp. Neighbouring rows differ by a multiple of
+// a step vector, so the system is solved and multiplied in O(n) without
+// ever storing the n x n elements.
+class Semiseparable {
+ public:
+  explicit Semiseparable(std::vector<double> g);
+  static Semiseparable FromGenerator(int k, int n);
+
+  int size() const;
+  double at(int col, int row) const;
+
+  Matrix operator*(const Matrix &x) const;
+
+ private:
+  std::vector<double> _g;
+};
+
+namespace Solver {
+void Solve(const Semiseparable &A, const Matrix &b, Matrix &x);
+double Discrepancy(const Semiseparable &A, const Matrix &b, const Matrix &x);
+}  // namespace Solver
@@ -0,0 +1,334 @@
+#include "service.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#include "solver.h"
+
+// Fixed size messages: the client names a segment, the server answers with
+// the residual or the text of the exception it caught
+struct Request {
+  char name[64];
+};
+
+struct Response {
+  int status;
+  double residual;
+  char error[96];
+};
+
+// Segment header, padded so that the matrices are aligned
+struct Header {
+  int n;
+  int k;
+  double padding;
+};
+
+void SendAll(int socket, const void *data, size_t size) {
+  const char *p = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t sent = send(socket, p, size, MSG_NOSIGNAL);
+    if (sent <= 0) throw std::runtime_error("Service error # 5");
+    p += sent;
+    size -= sent;
+  }
+}
+
+// False if the peer closed the connection before the first byte
+bool ReceiveAll(int socket, void *data, size_t size) {
+  char *p = static_cast<char *>(data);
+  for (size_t done = 0; done < size;) {
+    ssize_t got = recv(socket, p + done, size - done, 0);
+    if (got == 0 && done == 0) return false;
+    if (got <= 0) throw std::runtime_error("Service error # 5");
+    done += got;
+  }
+  return true;
+}
+
+// Bytes of the segment of an n x n system with k right-hand sides, false
+// for sizes below one or beyond the int offsets of the views
+bool SegmentBytes(int n, int k, size_t &bytes) {
+  if (n < 1 || k < 1) return false;
+  const size_t limit = std::numeric_limits<int>::max();
+  size_t width = static_cast<size_t>(n) + 2 * static_cast<size_t>(k);
+  if (width > limit || static_cast<size_t>(n) > limit / width) return false;
+  bytes = sizeof(Header) + sizeof(double) * (n * width);
+  return true;
+}
+
+sockaddr_un Address(const std::string &path) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(address.sun_path))
+    throw std::runtime_error("Service error # 1");
+  std::strcpy(address.sun_path, path.c_str());
+  return address;
+}
+
+SharedSystem::SharedSystem(int n, int k) : _owner(true), _n(n), _k(k) {
+  if (!SegmentBytes(n, k, _bytes))
+    throw std::runtime_error("Service error # 3");
+  static std::atomic<int> counter{0};
+  _name = "/solver-" + std::to_string(getpid()) + "-" +
+          std::to_string(counter++);
+  map(true);
+}
+
+SharedSystem::SharedSystem(const std::string &name)
+    : _name(name), _owner(false), _n(0), _k(0) {
+  map(false);
+}
+
+void SharedSystem::map(bool create) {
+  int fd = shm_open(_name.c_str(), create ? O_CREAT | O_EXCL | O_RDWR : O_RDWR,
+                    0600);
+  if (fd < 0) throw std::runtime_error("Service error # 3");
+  if (create) {
+    if (ftruncate(fd, _bytes) != 0) {
+      close(fd);
+      shm_unlink(_name.c_str());
+      throw std::runtime_error("Service error # 3");
+    }
+  } else {
+    struct stat info;
+    if (fstat(fd, &info) != 0 ||
+        info.st_size < static_cast<off_t>(sizeof(Header))) {
+      close(fd);
+      throw std::runtime_error("Service error # 3");
+    }
+    _bytes = info.st_size;
+  }
+  void *p = mmap(nullptr, _bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (p == MAP_FAILED) {
+    if (create) shm_unlink(_name.c_str());
+    throw std::runtime_error("Service error # 3");
+  }
+
+  auto *header = static_cast<Header *>(p);
+  if (create) {
+    header->n = _n;
+    header->k = _k;
+  } else {
+    // The header comes from another process, so its sizes are checked
+    // before any view is built over the segment
+    int n = header->n;
+    int k = header->k;
+    size_t needed;
+    if (!SegmentBytes(n, k, needed) || _bytes < needed) {
+      munmap(p, _bytes);
+      throw std::runtime_error("Service error # 3");
+    }
+    _n = n;
+    _k = k;
+  }
+  _data = reinterpret_cast<double *>(header + 1);
+}
+
+SharedSystem::~SharedSystem() {
+  munmap(reinterpret_cast<Header *>(_data) - 1, _bytes);
+  if (_owner) shm_unlink(_name.c_str());
+}
+
+const std::string &SharedSystem::name() const { return _name; }
+int SharedSystem::size() const { return _n; }
+int SharedSystem::columns() const { return _k; }
+
+Matrix SharedSystem::A() {
+  Matrix view(_n, _n, _data);
+  view.release();
+  return view;
+}
+
+Matrix SharedSystem::b() {
+  Matrix view(_k, _n, _data + _n * _n);
+  view.release();
+  return view;
+}
+
+Matrix SharedSystem::x() {
+  Matrix view(_k, _n, _data + _n * (_n + _k));
+  view.release();
+  return view;
+}
+
+Server::Server(std::string socket_path, int workers, size_t capacity)
+    : _path(std::move(socket_path)), _cache(capacity) {
+  if (workers < 1) throw std::runtime_error("Service error # 6");
+  sockaddr_un address = Address(_path);
+  _socket = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (_socket < 0) throw std::runtime_error("Service error # 2");
+  unlink(_path.c_str());
+  if (bind(_socket, reinterpret_cast<sockaddr *>(&address), sizeof(address)) ||
+      listen(_socket, 64)) {
+    close(_socket);
+    throw std::runtime_error("Service error # 2");
+  }
+  if (pipe(_wake) != 0) {
+    close(_socket);
+    throw std::runtime_error("Service error # 2");
+  }
+  for (int w = 0; w < workers; ++w) _workers.emplace_back(&Server::work, this);
+}
+
+Server::~Server() {
+  stop();
+  for (auto &worker : _workers) worker.join();
+  for (int connection : _idle) close(connection);
+  for (int connection : _connections) close(connection);
+  close(_wake[0]);
+  close(_wake[1]);
+  close(_socket);
+  unlink(_path.c_str());
+}
+
+void Server::run() {
+  std::vector<pollfd> polled;
+  while (!_stopped) {
+    polled.assign({{_socket, POLLIN, 0}, {_wake[0], POLLIN, 0}});
+    {
+      std::lock_guard<std::mutex> lock(_mutex);
+      for (int connection : _idle) polled.push_back({connection, POLLIN, 0});
+    }
+    if (poll(polled.data(), polled.size(), -1) < 0) continue;
+    if (polled[1].revents) {
+      char buffer[64];
+      if (read(_wake[0], buffer, sizeof(buffer)) < 0) continue;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_stopped) break;
+    if (polled[0].revents) {
+      int connection = accept(_socket, nullptr, nullptr);
+      if (connection >= 0) _idle.push_back(connection);
+    }
+    // A request or a hang-up, both are taken by a worker
+    for (size_t i = 2; i < polled.size(); ++i) {
+      if (!polled[i].revents) continue;
+      _idle.erase(std::find(_idle.begin(), _idle.end(), polled[i].fd));
+      _connections.push_back(polled[i].fd);
+      _ready.notify_one();
+    }
+  }
+}
+
+void Server::stop() {
+  std::lock_guard<std::mutex> lock(_mutex);
+  if (_stopped.exchange(true)) return;
+  // Wakes the poll and every worker waiting for a request
+  shutdown(_socket, SHUT_RDWR);
+  for (int connection : _connections) shutdown(connection, SHUT_RDWR);
+  for (int connection : _active) shutdown(connection, SHUT_RDWR);
+  wake();
+  _ready.notify_all();
+}
+
+void Server::wake() {
+  char byte = 0;
+  if (write(_wake[1], &byte, 1) < 0) return;
+}
+
+const Cache &Server::cache() const { return _cache; }
+
+void Server::work() {
+  for (;;) {
+    int connection;
+    {
+      std::unique_lock<std::mutex> lock(_mutex);
+      _ready.wait(lock, [this] { return _stopped || !_connections.empty(); });
+      if (_stopped) return;
+      connection = _connections.front();
+      _connections.pop_front();
+      _active.push_back(connection);
+    }
+    bool open = false;
+    try {
+      open = serve(connection);
+    } catch (std::runtime_error &) {
+      // The client went away in the middle of a message
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _active.erase(std::find(_active.begin(), _active.end(), connection));
+    if (open && !_stopped) {
+      _idle.push_back(connection);
+      wake();
+    } else {
+      close(connection);
+    }
+  }
+}
+
+bool Server::serve(int connection) {
+  Request request;
+  if (!ReceiveAll(connection, &request, sizeof(request))) return false;
+  request.name[sizeof(request.name) - 1] = '\0';
+  Response response{};
+  try {
+    SharedSystem system(request.name);
+    Matrix A = system.A();
+    Matrix b = system.b();
+    Matrix result(system.columns(), system.size());
+    Solver::Solve(A, b, result, _cache);
+    Matrix x = system.x();
+    for (int j = 0; j < x.rows(); ++j)
+      for (int i = 0; i < x.cols(); ++i) x[{i, j}] = result[{i, j}];
+    response.residual = Solver::Discrepancy(A, b, result);
+  } catch (std::exception &e) {
+    response.status = 1;
+    std::strncpy(response.error, e.what(), sizeof(response.error) - 1);
+  }
+  SendAll(connection, &response, sizeof(response));
+  return true;
+}
+
+Client::Client(const std::string &socket_path) {
+  sockaddr_un address = Address(socket_path);
+  _socket = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (_socket < 0) throw std::runtime_error("Service error # 4");
+  if (connect(_socket, reinterpret_cast<sockaddr *>(&address),
+              sizeof(address))) {
+    close(_socket);
+    throw std::runtime_error("Service error # 4");
+  }
+}
+
+Client::~Client() { close(_socket); }
+
+double Client::solve(SharedSystem &system) {
+  Request request{};
+  std::strncpy(request.name, system.name().c_str(), sizeof(request.name) - 1);
+  SendAll(_socket, &request, sizeof(request));
+  Response response;
+  if (!ReceiveAll(_socket, &response, sizeof(response)))
+    throw std::runtime_error("Service error # 5");
+  // Errors of the solver reach the caller with their own text
+  if (response.status != 0) throw std::runtime_error(response.error);
+  return response.residual;
+}
+
+double Client::solve(const Matrix &A, const Matrix &b, Matrix &x) {
+  const int n = A.rows();
+  if (A.cols() != n || b.rows() != n)
+    throw std::runtime_error("Solver error # 2");
+  SharedSystem system(n, b.cols());
+  Matrix sA = system.A();
+  Matrix sb = system.b();
+  for (int j = 0; j < n; ++j) {
+    for (int i = 0; i < n; ++i) sA[{i, j}] = A[{i, j}];
+    for (int i = 0; i < b.cols(); ++i) sb[{i, j}] = b[{i, j}];
+  }
+  double residual = solve(system);
+  const Matrix solution = system.x();
+  x = Matrix(solution);
+  return residual;
+}
@@ -0,0 +1,98 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "cache.h"
+#include "matrix.h"
+
+// A, b and x of one system in POSIX shared memory. The client fills A and
+// b in place and the server solves on views of the same pages, so matrices
+// never pass through the socket.
+class SharedSystem {
+ public:
+  // Creates a new segment for an n x n system with k right-hand sides
+  SharedSystem(int n, int k);
+  // Maps a segment created by another process
+  explicit SharedSystem(const std::string &name);
+  SharedSystem(const SharedSystem &) = delete;
+  SharedSystem &operator=(const SharedSystem &) = delete;
+  ~SharedSystem();
+
+  const std::string &name() const;
+  int size() const;
+  int columns() const;
+  // Views over the segment, valid while it is mapped
+  Matrix A();
+  Matrix b();
+  Matrix x();
+
+ private:
+  void map(bool create);
+
+  std::string _name;
+  bool _owner;
+  int _n;
+  int _k;
+  size_t _bytes{0};
+  double *_data{nullptr};
+};
+
+// Solves systems for clients on a Unix domain socket. run() polls the
+// connections between their requests and queues each request for a pool
+// of workers, so an idle client holds no worker. Factorizations of recent
+// matrices are kept in a cache shared by all of them.
+class Server {
+ public:
+  Server(std::string socket_path, int workers = 1, size_t capacity = 16);
+  Server(const Server &) = delete;
+  Server &operator=(const Server &) = delete;
+  ~Server();
+
+  // Serves until stop() is called
+  void run();
+  void stop();
+  const Cache &cache() const;
+
+ private:
+  void work();
+  // Answers one request, false when the client has hung up
+  bool serve(int connection);
+  void wake();
+
+  std::string _path;
+  int _socket;
+  Cache _cache;
+  std::vector<std::thread> _workers;
+  std::atomic<bool> _stopped{false};
+  std::mutex _mutex;
+  std::condition_variable _ready;
+  // Connections with a request waiting for a worker
+  std::deque<int> _connections;
+  // Connections taken by the workers
+  std::vector<int> _active;
+  // Connections between requests, polled by run()
+  std::vector<int> _idle;
+  // Pipe that interrupts the poll when _idle changes or on stop()
+  int _wake[2];
+};
+
+class Client {
+ public:
+  explicit Client(const std::string &socket_path);
+  Client(const Client &) = delete;
+  Client &operator=(const Client &) = delete;
+  ~Client();
+
+  // Solution goes to system.x(), returns the residual computed by the server
+  double solve(SharedSystem &system);
+  // The same through a temporary segment
+  double solve(const Matrix &A, const Matrix &b, Matrix &x);
+
+ private:
+  int _socket;
+};
@@ -1,69 +1,356 @@
 #include "solver.h"
 
 #include <iostream>
+#include <numeric>
+#include <vector>
 
+#include "ddouble.h"
 #include "profiler.h"
+#include "symmetric.h"
+#include "toeplitz.h"
 
-void Solver::Direct(Matrix &A, Matrix &B, Matrix &x) {
+Solver::Control::Control(Callback on_progress)
+    : _on_progress(std::move(on_progress)) {}
+
+void Solver::Control::cancel() { _cancelled = true; }
+
+bool Solver::Control::cancelled() const { return _cancelled; }
+
+void Solver::Control::set_deadline(Clock::time_point deadline) {
+  _deadline = deadline;
+}
+
+void Solver::Control::set_timeout(Clock::duration timeout) {
+  _deadline = Clock::now() + timeout;
+}
+
+void Solver::Control::check() const {
+  if (_cancelled) throw std::runtime_error("Solver error # 3");
+  if (_deadline && Clock::now() > *_deadline)
+    throw std::runtime_error("Solver error # 4");
+}
+
+void Solver::Control::step(int done, int total) const {
+  check();
+  if (_on_progress) _on_progress(done, total);
+}
+
+Solver::Workspace::Workspace(int n, int k) : _n(n), _k(k) {
+  if (n < 1 || k < 1) throw std::runtime_error("Solver error # 2");
+  _data.assign(static_cast<size_t>(n) * (n + k + 1), 0.0);
+}
+
+int Solver::Workspace::size() const { return _n; }
+int Solver::Workspace::columns() const { return _k; }
+
+Matrix Solver::Workspace::augmented(int n, int k) {
+  if (n > _n || k > _k) throw std::runtime_error("Solver error # 10");
+  Matrix AB(n + k, n, _data.data());
+  AB.release();
+  return AB;
+}
+
+Matrix Solver::Workspace::permutation(int n) {
+  if (n > _n) throw std::runtime_error("Solver error # 10");
+  Matrix x(1, n, _data.data() + static_cast<size_t>(_n) * (_n + _k));
+  x.release();
+  return x;
+}
+
+Index Solver::Pivoting::Full::Find(const Matrix &A, int i) {
+  const int n = A.rows();
+  Index max{i, i};
+  double value = std::abs(A[max]);
+  for (int j = i; j < n; ++j)
+    for (int k = i; k < n; ++k)
+      if (std::abs(A[{k, j}]) > value) {
+        max = {k, j};
+        value = std::abs(A[max]);
+      }
+  return max;
+}
+
+Index Solver::Pivoting::Rook::Find(const Matrix &A, int i) {
+  const int n = A.rows();
+  Index max = Partial::Find(A, i);
+  // Alternate between the row and the column of the candidate until it is
+  // the largest in both
+  for (bool by_row = true;; by_row = !by_row) {
+    Index next = max;
+    for (int k = i; k < n; ++k) {
+      Index candidate = by_row ? Index{k, max.row} : Index{max.col, k};
+      if (std::abs(A[candidate]) > std::abs(A[next])) next = candidate;
+    }
+    if (next == max) return max;
+    max = next;
+  }
+}
+
+Index Solver::Pivoting::Partial::Find(const Matrix &A, int i) {
+  const int n = A.rows();
+  Index max{i, i};
+  for (int j = i + 1; j < n; ++j)
+    if (std::abs(A[{i, j}]) > std::abs(A[max])) max = {i, j};
+  return max;
+}
+
+Index Solver::Pivoting::None::Find(const Matrix &, int i) { return {i, i}; }
+
+// One step of the direct pass: pivot i is moved to the diagonal, its row
+// is normalized and subtracted from the rows below
+template <class Pivot>
+void Eliminate(Matrix &A, Matrix &B, Matrix &x, int i) {
+  int n = B.rows();
+  Index max = Pivot::Find(A, i);
+  double pivot = A[max];
+  if (std::abs(pivot) < 1e-14) throw std::runtime_error("Solver error # 1");
+
+  A.swap(i, max.row, 'r');
+  B.swap(i, max.row, 'r');
+
+  A.swap(i, max.col, 'c');
+  x.swap(i, max.col, 'r');
+
+  double scale = 1. / pivot;
+  A.row(i) *= scale;
+  B.row(i) *= scale;
+  for (int j = i + 1; j < n; ++j) {
+    B.row(j).add_scaled(B.row(i), -A[{i, j}]);
+    A.submat({i, j}, {n - 1, j})
+        .add_scaled(A.submat({i, i}, {n - 1, i}), -A[{i, j}]);
+  }
+}
+
+template <class Pivot>
+void Solver::Direct(Matrix &A, Matrix &B, Matrix &x, const Control *control) {
   LOG_DURATION("Algorithm direct step time");
   int n = B.rows();
   for (int i = 0; i < n; ++i) x[{0, i}] = i;
   for (int i = 0; i < n; ++i) {
-    auto max =
-        A.submat({i, i}, {n - 1, n - 1}).max_element([](double a, double b) {
-          return std::abs(a) < std::abs(b);
-        });
-    if (std::abs(max.second) < 1e-14)
-      throw std::runtime_error("Solver error # 1");
-
-    A.swap(i, i + max.first.row, 'r');
-    B.swap(i, i + max.first.row, 'r');
-
-    A.swap(i, i + max.first.col, 'c');
-    x.swap(i, i + max.first.col, 'r');
-
-    double scale = 1. / max.second;
-    A.row(i) *= scale;
-    B.row(i) *= scale;
-    for (int j = i + 1; j < n; ++j) {
-      B.row(j).add_scaled(B.row(i), -A[{i, j}]);
-      A.submat({i, j}, {n - 1, j})
-          .add_scaled(A.submat({i, i}, {n - 1, i}), -A[{i, j}]);
+    if (control) control->step(i, n);
+    Eliminate<Pivot>(A, B, x, i);
+  }
+  if (control) control->step(n, n);
+}
+
+// The same step on augmented rows [A | B], where the row update of A and
+// B is one add_scaled call over a contiguous segment
+template <class Pivot>
+void EliminateAugmented(Matrix &AB, Matrix &x, int i) {
+  int n = AB.rows();
+  int w = AB.cols();
+  Index max = Pivot::Find(AB.submat({0, 0}, {n - 1, n - 1}), i);
+  double pivot = AB[max];
+  if (std::abs(pivot) < 1e-14) throw std::runtime_error("Solver error # 1");
+
+  AB.swap(i, max.row, 'r');
+  AB.swap(i, max.col, 'c');
+  x.swap(i, max.col, 'r');
+
+  auto row = AB.submat({i, i}, {w - 1, i});
+  row *= 1. / pivot;
+  for (int j = i + 1; j < n; ++j)
+    AB.submat({i, j}, {w - 1, j}).add_scaled(row, -AB[{i, j}]);
+}
+
+template <class Pivot>
+void DirectPass(Matrix &AB, Matrix &x, const Solver::Control *control) {
+  int n = AB.rows();
+  if (AB.cols() <= n || x.rows() != n)
+    throw std::runtime_error("Solver error # 2");
+  for (int i = 0; i < n; ++i) x[{0, i}] = i;
+  for (int i = 0; i < n; ++i) {
+    if (control) control->step(i, n);
+    EliminateAugmented<Pivot>(AB, x, i);
+  }
+  if (control) control->step(n, n);
+}
+
+void ReversePass(Matrix &AB, const Solver::Control *control) {
+  int n = AB.rows();
+  int w = AB.cols();
+  for (int i = n - 1; i > 0; --i) {
+    if (control) control->check();
+    auto row = AB.submat({n, i}, {w - 1, i});
+    for (int j = 0; j < i; ++j) {
+      AB.submat({n, j}, {w - 1, j}).add_scaled(row, -AB[{i, j}]);
+      AB[{i, j}] = 0.0;
     }
   }
 }
 
-void Solver::Reverse(Matrix &A, Matrix &B) {
+template <class Pivot>
+void Solver::DirectAugmented(Matrix &AB, Matrix &x, const Control *control) {
+  LOG_DURATION("Algorithm direct step time");
+  DirectPass<Pivot>(AB, x, control);
+}
+
+void Solver::ReverseAugmented(Matrix &AB, const Control *control) {
+  LOG_DURATION("Algorithm reverse step time");
+  ReversePass(AB, control);
+}
+
+// Copies A and B into one augmented matrix [A | B]
+Matrix Augment(const Matrix &A, const Matrix &B) {
+  const int n = A.cols();
+  return Matrix(n + B.cols(), A.rows(), [&A, &B, n](int i, int j) {
+    return i < n ? A[{i, j}] : B[{i - n, j}];
+  });
+}
+
+// Right-hand side part of an augmented matrix
+Matrix Solution(Matrix &AB) {
+  const int n = AB.rows();
+  const auto B = AB.submat({n, 0}, {AB.cols() - 1, n - 1});
+  return Matrix(B);
+}
+
+void Solver::Reverse(Matrix &A, Matrix &B, const Control *control) {
   LOG_DURATION("Algorithm reverse step time");
   int n = B.rows();
-  for (int i = n - 1; i > 0; --i)
+  for (int i = n - 1; i > 0; --i) {
+    if (control) control->check();
     for (int j = 0; j < i; ++j) {
       B.row(j).add_scaled(B.row(i), -A[{i, j}]);
       A[{i, j}] = 0.0;
     }
+  }
 }
 
-void Solver::Solve(const Matrix &A, const Matrix &B, Matrix &x) {
-  int n = x.rows();
-  if (B.rows() != n || A.cols() != n || A.rows() != n)
-    throw std::runtime_error("Solver error # 2");
-
-  Matrix _A(A);
-  Matrix _B(B);
-  LOG_DURATION("Algorithm full time");
-  Direct(_A, _B, x);
-  Reverse(_A, _B);
+// Undoes the column permutation recorded in x by Direct
+void Unpermute(Matrix &B, Matrix &x) {
   for (int i = 0; i < x.rows(); ++i) {
     int j = static_cast<int>(x[{0, i}]);
     while (i != j) {
       x.swap(i, j, 'r');
-      _B.swap(i, j, 'r');
+      B.swap(i, j, 'r');
       j = static_cast<int>(x[{0, i}]);
     }
   }
+}
+
+// Relative residual above which a Levinson solution is discarded
+constexpr double kLevinsonResidual = 1e-10;
+
+// Symmetric with a positive diagonal, like the covariance matrices Levinson
+// is meant for
+bool LevinsonCandidate(const Toeplitz &T) {
+  if (!(T.t(0) > 0)) return false;
+  for (int k = 1; k < T.size(); ++k)
+    if (T.t(k) != T.t(-k)) return false;
+  return true;
+}
+
+void Solver::Solve(const Matrix &A, const Matrix &B, Matrix &x) {
+  int n = x.rows();
+  if (B.rows() != n || A.cols() != n || A.rows() != n)
+    throw std::runtime_error("Solver error # 2");
+  // Structured systems are detected in O(n^2), usually after a few elements
+  if (auto T = Toeplitz::Detect(A)) {
+    // Levinson is unstable without pivoting unless the leading minors are
+    // well away from singular, so its answer is checked before use
+    if (LevinsonCandidate(*T)) {
+      Matrix _B(B);
+      if (Levinson(*T, _B) &&
+          Discrepancy(*T, B, _B) <= kLevinsonResidual * (B.norm() + 1)) {
+        x = std::move(_B);
+        return;
+      }
+    }
+  }
+  // Symmetric systems need half the memory and a third of the work
+  if (IsSymmetric(A)) {
+    SolveSymmetric(A, B, x);
+    return;
+  }
+
+  Solve<Pivoting::Full>(A, B, x);
+}
+
+template <class Pivot>
+void Solver::Solve(const Matrix &A, const Matrix &B, Matrix &x) {
+  int n = x.rows();
+  if (B.rows() != n || A.cols() != n || A.rows() != n)
+    throw std::runtime_error("Solver error # 2");
+
+  Matrix AB = Augment(A, B);
+  LOG_DURATION("Algorithm full time");
+  DirectAugmented<Pivot>(AB, x);
+  ReverseAugmented(AB);
+  Matrix _B = Solution(AB);
+  Unpermute(_B, x);
   x = std::move(_B);
 }
 
+template <class Pivot>
+void Solver::Solve(const Matrix &A, const Matrix &B, Matrix &x,
+                   Workspace &workspace) {
+  const int n = A.rows();
+  const int k = B.cols();
+  if (A.cols() != n || B.rows() != n || x.rows() != n || x.cols() != k)
+    throw std::runtime_error("Solver error # 2");
+
+  Matrix AB = workspace.augmented(n, k);
+  for (int j = 0; j < n; ++j) {
+    for (int i = 0; i < n; ++i) AB[{i, j}] = A[{i, j}];
+    for (int c = 0; c < k; ++c) AB[{n + c, j}] = B[{c, j}];
+  }
+  Matrix perm = workspace.permutation(n);
+  DirectPass<Pivot>(AB, perm, nullptr);
+  ReversePass(AB, nullptr);
+  for (int i = 0; i < n; ++i) {
+    const int j = static_cast<int>(perm[{0, i}]);
+    for (int c = 0; c < k; ++c) x[{c, j}] = AB[{n + c, i}];
+  }
+}
+
+template <class Pivot>
+Solver::Report Solver::Analyze(const Matrix &A, const Matrix &B) {
+  int n = A.rows();
+  if (B.rows() != n || A.cols() != n)
+    throw std::runtime_error("Solver error # 2");
+
+  Matrix _A(A);
+  Matrix _B(B);
+  Matrix x(1, n);
+  for (int i = 0; i < n; ++i) x[{0, i}] = i;
+  const double max = std::abs(A.max_element([](double a, double b) {
+                                 return std::abs(a) < std::abs(b);
+                               }).second);
+  Report report{1.0, 0.0};
+  for (int i = 0; i < n - 1; ++i) {
+    Eliminate<Pivot>(_A, _B, x, i);
+    auto active = _A.submat({i + 1, i + 1}, {n - 1, n - 1});
+    double value = std::abs(active.max_element([](double a, double b) {
+                                    return std::abs(a) < std::abs(b);
+                                  }).second);
+    report.growth = std::max(report.growth, value / max);
+  }
+  Eliminate<Pivot>(_A, _B, x, n - 1);
+  Reverse(_A, _B);
+  Unpermute(_B, x);
+  report.residual = Discrepancy(A, B, _B);
+  return report;
+}
+
+#define SOLVER_INSTANTIATE(Pivot)                                          \
+  template void Solver::Direct<Solver::Pivoting::Pivot>(                   \
+      Matrix &, Matrix &, Matrix &, const Control *);                      \
+  template void Solver::DirectAugmented<Solver::Pivoting::Pivot>(          \
+      Matrix &, Matrix &, const Control *);                                \
+  template void Solver::Solve<Solver::Pivoting::Pivot>(                    \
+      const Matrix &, const Matrix &, Matrix &);                           \
+  template void Solver::Solve<Solver::Pivoting::Pivot>(                    \
+      const Matrix &, const Matrix &, Matrix &, Workspace &);              \
+  template Solver::Report Solver::Analyze<Solver::Pivoting::Pivot>(        \
+      const Matrix &, const Matrix &);
+
+SOLVER_INSTANTIATE(Full)
+SOLVER_INSTANTIATE(Rook)
+SOLVER_INSTANTIATE(Partial)
+SOLVER_INSTANTIATE(None)
+
+
 double Solver::Discrepancy(const Matrix &A, const Matrix &B, const Matrix &x) {
   LOG_DURATION("Error calculation time");
   Matrix result;
@@ -85,4 +372,117 @@ double Solver::Async::Discrepancy(const Matrix &A, const Matrix &B,
   }
   result -= B;
   return result.norm();
-}
\ No newline at end of file
+}
+
+void Solver::Solve(const Matrix &A, const Matrix &B, Matrix &x,
+                   Precision precision) {
+  if (precision == Precision::Double) {
+    Solve(A, B, x);
+    return;
+  }
+  const int n = x.rows();
+  if (B.rows() != n || A.cols() != n || A.rows() != n)
+    throw std::runtime_error("Solver error # 2");
+
+  LOG_DURATION("Algorithm double-double time");
+  // Augmented rows [A | B], hi and lo parts stored apart for the kernels
+  const int k = B.cols();
+  const int w = n + k;
+  std::vector<double> hi(static_cast<size_t>(n) * w), lo(hi.size(), 0.0);
+  double norm = 0;
+  for (int j = 0; j < n; ++j) {
+    for (int i = 0; i < n; ++i) {
+      hi[j * w + i] = A[{i, j}];
+      norm = std::max(norm, std::abs(A[{i, j}]));
+    }
+    for (int c = 0; c < k; ++c) hi[j * w + n + c] = B[{c, j}];
+  }
+  auto at = [&](int col, int row) {
+    return DDouble{hi[row * w + col], lo[row * w + col]};
+  };
+
+  std::vector<int> perm(n);
+  std::iota(perm.begin(), perm.end(), 0);
+  for (int i = 0; i < n; ++i) {
+    int pivot_col = i;
+    int pivot_row = i;
+    double max = 0;
+    for (int j = i; j < n; ++j)
+      for (int c = i; c < n; ++c)
+        if (std::abs(hi[j * w + c]) > max) {
+          max = std::abs(hi[j * w + c]);
+          pivot_col = c;
+          pivot_row = j;
+        }
+    if (max <= 1e-30 * norm) throw std::runtime_error("Solver error # 1");
+
+    if (pivot_row != i)
+      for (int c = 0; c < w; ++c) {
+        std::swap(hi[i * w + c], hi[pivot_row * w + c]);
+        std::swap(lo[i * w + c], lo[pivot_row * w + c]);
+      }
+    if (pivot_col != i) {
+      for (int j = 0; j < n; ++j) {
+        std::swap(hi[j * w + i], hi[j * w + pivot_col]);
+        std::swap(lo[j * w + i], lo[j * w + pivot_col]);
+      }
+      std::swap(perm[i], perm[pivot_col]);
+    }
+
+    const int len = w - i;
+    Scale(&hi[i * w + i], &lo[i * w + i], DDouble{1.0, 0.0} / at(i, i), len);
+    for (int j = i + 1; j < n; ++j)
+      AddScaled(&hi[j * w + i], &lo[j * w + i], &hi[i * w + i], &lo[i * w + i],
+                -at(i, j), len);
+  }
+
+  for (int i = n - 1; i > 0; --i)
+    for (int j = 0; j < i; ++j)
+      AddScaled(&hi[j * w + n], &lo[j * w + n], &hi[i * w + n], &lo[i * w + n],
+                -at(i, j), k);
+
+  Matrix result(k, n);
+  for (int i = 0; i < n; ++i)
+    for (int c = 0; c < k; ++c) result[{c, perm[i]}] = at(n + c, i).hi;
+  x = std::move(result);
+}
+
+double Solver::Discrepancy(const Matrix &A, const Matrix &B, const Matrix &x,
+                           Precision precision) {
+  if (precision == Precision::Double) return Discrepancy(A, B, x);
+  if (A.cols() != x.rows() || A.rows() != B.rows() || B.cols() != x.cols())
+    throw std::runtime_error("Solver error # 2");
+
+  LOG_DURATION("Error calculation time");
+  const int m = A.cols();
+  std::vector<double> row(m), column(m);
+  DDouble sum{0.0, 0.0};
+  for (int c = 0; c < x.cols(); ++c) {
+    for (int i = 0; i < m; ++i) column[i] = x[{c, i}];
+    for (int j = 0; j < A.rows(); ++j) {
+      for (int i = 0; i < m; ++i) row[i] = A[{i, j}];
+      DDouble r = Dot(row.data(), column.data(), m) - DDouble{B[{c, j}], 0.0};
+      sum = sum + r * r;
+    }
+  }
+  return sqrt(sum.hi);
+}
+
+std::future<Matrix> Solver::Async::Solve(
+    const Matrix &A, const Matrix &B, std::shared_ptr<const Control> control) {
+  int n = A.rows();
+  if (B.rows() != n || A.cols() != n)
+    throw std::runtime_error("Solver error # 2");
+
+  // The task owns its copy, so the caller may release A and B right away
+  return std::async(std::launch::async,
+                    [AB = Augment(A, B), control]() mutable {
+                      LOG_DURATION("Algorithm async full time");
+                      Matrix x(1, AB.rows());
+                      DirectAugmented(AB, x, control.get());
+                      ReverseAugmented(AB, control.get());
+                      Matrix _B = Solution(AB);
+                      Unpermute(_B, x);
+                      return _B;
+                    });
+}
@@ -1,13 +1,122 @@
 #pragma once
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <vector>
+
 #include "matrix.h"
 
 namespace Solver {
-void Direct(Matrix &A, Matrix &b, Matrix &x);
-void Reverse(Matrix &A, Matrix &b);
+// Progress, cancellation and deadline of a running solve. Checked once per
+// pivot, so a cancelled solve stops after at most one elimination step.
+class Control {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Callback = std::function<void(int done, int total)>;
+
+  Control() = default;
+  explicit Control(Callback on_progress);
+
+  void cancel();
+  bool cancelled() const;
+  void set_deadline(Clock::time_point deadline);
+  void set_timeout(Clock::duration timeout);
+
+  void check() const;
+  void step(int done, int total) const;
+
+ private:
+  std::atomic<bool> _cancelled{false};
+  std::optional<Clock::time_point> _deadline;
+  Callback _on_progress;
+};
+
+// Storage of Solve for systems up to n x n with up to k right-hand sides.
+// Created once and passed to every call, so repeated solves allocate no
+// matrices (see Matrix::allocations).
+class Workspace {
+ public:
+  explicit Workspace(int n, int k = 1);
+
+  int size() const;
+  int columns() const;
+  // Views over the storage: [A | B] of an n x n system and the permutation
+  Matrix augmented(int n, int k);
+  Matrix permutation(int n);
+
+ private:
+  int _n;
+  int _k;
+  std::vector<double> _data;
+};
+
+// Pivoting policies of the direct pass. Find returns the position of the
+// pivot within the active submatrix A[i.., i..]; the choice is made at
+// compile time, so every policy gets its own elimination loop.
+namespace Pivoting {
+// Largest element of the whole active submatrix
+struct Full {
+  static Index Find(const Matrix &A, int i);
+};
+// Element that is largest both in its row and in its column
+struct Rook {
+  static Index Find(const Matrix &A, int i);
+};
+// Largest element of column i, rows only are swapped
+struct Partial {
+  static Index Find(const Matrix &A, int i);
+};
+// Diagonal element, for diagonally dominant matrices
+struct None {
+  static Index Find(const Matrix &A, int i);
+};
+}  // namespace Pivoting
+
+template <class Pivot = Pivoting::Full>
+void Direct(Matrix &A, Matrix &b, Matrix &x, const Control *control = nullptr);
+void Reverse(Matrix &A, Matrix &b, const Control *control = nullptr);
+// The same passes on augmented storage [A | B]: A is the leading n x n
+// block of AB, so every row update touches A and B in one sweep
+template <class Pivot = Pivoting::Full>
+void DirectAugmented(Matrix &AB, Matrix &x, const Control *control = nullptr);
+void ReverseAugmented(Matrix &AB, const Control *control = nullptr);
+// Picks a structured solver when A allows it, Jordan elimination otherwise.
+// Levinson is tried only on symmetric Toeplitz matrices with a positive
+// diagonal, and its answer is kept only if the residual, through the FFT
+// product, is small; else the system goes on to the symmetric or the
+// general path like any other.
+void Solve(const Matrix &A, const Matrix &b, Matrix &x);
+// Jordan elimination with the given pivoting
+template <class Pivot>
 void Solve(const Matrix &A, const Matrix &b, Matrix &x);
+// The same in the storage of workspace: x must already have the shape of b,
+// structured solvers and timing logs are skipped
+template <class Pivot = Pivoting::Full>
+void Solve(const Matrix &A, const Matrix &b, Matrix &x, Workspace &workspace);
+
+// Growth factor max |a_ij^(k)| / max |a_ij| of the direct pass and the
+// residual of the solution, to choose a pivoting policy for a class of input
+struct Report {
+  double growth;
+  double residual;
+};
+template <class Pivot>
+Report Analyze(const Matrix &A, const Matrix &b);
 double Discrepancy(const Matrix &A, const Matrix &b, const Matrix &x);
+
+// DoubleDouble runs full-pivot Gauss elimination and the residual in
+// double-double arithmetic (ddouble.h), for ill-conditioned systems
+enum class Precision { Double, DoubleDouble };
+void Solve(const Matrix &A, const Matrix &b, Matrix &x, Precision precision);
+double Discrepancy(const Matrix &A, const Matrix &b, const Matrix &x,
+                   Precision precision);
 namespace Async {
 double Discrepancy(const Matrix &A, const Matrix &b, const Matrix &x,
                    int workers);
+std::future<Matrix> Solve(const Matrix &A, const Matrix &b,
+                          std::shared_ptr<const Control> control = nullptr);
 } // namespace Async
-} // namespace Solver
\ No newline at end of file
+} // namespace Solver
@@ -0,0 +1,165 @@
+#include "svd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+#include "parallel.h"
+#include "profiler.h"
+
+// Orthogonalizes the rows x and y of length m, the same rotation is applied
+// to the rows u and v of length n. Returns false if their cosine is within
+// tolerance, i.e. they are orthogonal in working precision.
+bool Rotate(double *x, double *y, int m, double *u, double *v, int n,
+            double tolerance) {
+  double alpha = 0;
+  double beta = 0;
+  double gamma = 0;
+  for (int i = 0; i < m; ++i) {
+    alpha += x[i] * x[i];
+    beta += y[i] * y[i];
+    gamma += x[i] * y[i];
+  }
+  if (std::abs(gamma) <= tolerance * sqrt(alpha * beta)) return false;
+
+  const double zeta = (beta - alpha) / (2 * gamma);
+  const double t =
+      std::copysign(1.0, zeta) / (std::abs(zeta) + sqrt(1 + zeta * zeta));
+  const double c = 1 / sqrt(1 + t * t);
+  const double s = c * t;
+  for (int i = 0; i < m; ++i) {
+    const double a = x[i];
+    const double b = y[i];
+    x[i] = c * a - s * b;
+    y[i] = s * a + c * b;
+  }
+  for (int i = 0; i < n; ++i) {
+    const double a = u[i];
+    const double b = v[i];
+    u[i] = c * a - s * b;
+    v[i] = s * a + c * b;
+  }
+  return true;
+}
+
+SVD::SVD(const Matrix &A, int workers, bool vectors)
+    : _m(A.rows()), _n(A.cols()) {
+  if (_m < _n) throw std::domain_error("SVD error # 1");
+  if (workers < 1) throw std::domain_error("SVD error # 2");
+
+  LOG_DURATION("Jacobi SVD time");
+  std::vector<double> W(static_cast<size_t>(_n) * _m);
+  for (int j = 0; j < _m; ++j)
+    for (int i = 0; i < _n; ++i)
+      W[static_cast<size_t>(i) * _m + j] = A[{i, j}];
+  const int vn = vectors ? _n : 0;
+  std::vector<double> V(static_cast<size_t>(_n) * vn, 0.0);
+  for (int i = 0; i < vn; ++i) V[static_cast<size_t>(i) * _n + i] = 1;
+
+  // Round-robin tournament: position 0 stays, the others move by one. An
+  // odd number of columns gets a dummy that sits out its rounds.
+  const int N = _n + _n % 2;
+  std::vector<int> order(N);
+  std::iota(order.begin(), order.end(), 0);
+  const int pairs = N / 2;
+  workers = std::min(workers, std::max(1, pairs));
+  std::vector<char> rotated(workers);
+  // The rounding of a dot product of length m is about sqrt(m) eps, so a
+  // bare eps may never be met on tall matrices (LAPACK dgesvj uses the same)
+  const double tolerance =
+      sqrt(static_cast<double>(_m)) * std::numeric_limits<double>::epsilon();
+
+  for (bool changed = true; changed;) {
+    if (++_sweeps > 60) throw std::runtime_error("SVD error # 3");
+    changed = false;
+    for (int round = 0; round + 1 < N; ++round) {
+      std::fill(rotated.begin(), rotated.end(), 0);
+      auto pair = [&](int w) {
+        for (int k = w; k < pairs; k += workers) {
+          int p = order[k];
+          int q = order[N - 1 - k];
+          if (p >= _n || q >= _n) continue;
+          if (p > q) std::swap(p, q);
+          rotated[w] |= Rotate(&W[static_cast<size_t>(p) * _m],
+                               &W[static_cast<size_t>(q) * _m], _m,
+                               V.data() + static_cast<size_t>(p) * vn,
+                               V.data() + static_cast<size_t>(q) * vn, vn,
+                               tolerance);
+        }
+      };
+      // Rounds of small matrices are cheaper than starting the threads
+      if (workers > 1 && _m >= 64) {
+        Parallel(workers, pair);
+      } else {
+        for (int w = 0; w < workers; ++w) pair(w);
+      }
+      for (char r : rotated) changed |= r;
+      std::rotate(order.begin() + 1, order.end() - 1, order.end());
+    }
+  }
+
+  std::vector<double> norm(_n);
+  for (int i = 0; i < _n; ++i) {
+    const double *w = &W[static_cast<size_t>(i) * _m];
+    double sum = 0;
+    for (int j = 0; j < _m; ++j) sum += w[j] * w[j];
+    norm[i] = sqrt(sum);
+  }
+  std::vector<int> index(_n);
+  std::iota(index.begin(), index.end(), 0);
+  std::stable_sort(index.begin(), index.end(),
+                   [&norm](int a, int b) { return norm[a] > norm[b]; });
+
+  _s.resize(_n);
+  for (int i = 0; i < _n; ++i) _s[i] = norm[index[i]];
+  if (!vectors) return;
+  _U.resize(W.size());
+  _V.resize(V.size());
+  for (int i = 0; i < _n; ++i) {
+    const double *w = &W[static_cast<size_t>(index[i]) * _m];
+    const double scale = _s[i] > 0 ? 1 / _s[i] : 0.0;
+    double *u = &_U[static_cast<size_t>(i) * _m];
+    for (int j = 0; j < _m; ++j) u[j] = w[j] * scale;
+    std::copy_n(&V[static_cast<size_t>(index[i]) * _n], _n,
+                &_V[static_cast<size_t>(i) * _n]);
+  }
+}
+
+const std::vector<double> &SVD::values() const { return _s; }
+
+Matrix SVD::U() const {
+  if (_U.empty()) throw std::logic_error("SVD error # 4");
+  return Matrix(_n, _m, [this](int i, int j) {
+    return _U[static_cast<size_t>(i) * _m + j];
+  });
+}
+
+Matrix SVD::V() const {
+  if (_V.empty()) throw std::logic_error("SVD error # 4");
+  return Matrix(_n, _n, [this](int i, int j) {
+    return _V[static_cast<size_t>(i) * _n + j];
+  });
+}
+
+int SVD::rank(double tolerance) const {
+  if (_s.empty()) return 0;
+  if (tolerance < 0)
+    tolerance = _m * std::numeric_limits<double>::epsilon() * _s[0];
+  int r = 0;
+  while (r < _n && _s[r] > tolerance) ++r;
+  return r;
+}
+
+double SVD::condition() const {
+  if (_s.empty() || _s.back() == 0)
+    return std::numeric_limits<double>::infinity();
+  return _s[0] / _s.back();
+}
+
+int SVD::sweeps() const { return _sweeps; }
+
+std::vector<double> Solver::SingularValues(const Matrix &A, int workers) {
+  return SVD(A, workers, false).values();
+}
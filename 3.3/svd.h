@@ -0,0 +1,38 @@
+#pragma once
+#include <vector>
+
+#include "matrix.h"
+
+// A = U diag(s) V^T for an m x n matrix, m >= n, by one-sided Jacobi
+// rotations. A sweep visits all column pairs in a round-robin order where
+// every round is a set of disjoint pairs, so a round is shared among the
+// workers. Columns are stored transposed to keep the rotations contiguous.
+class SVD {
+ public:
+  explicit SVD(const Matrix &A, int workers = 1, bool vectors = true);
+
+  // Singular values in descending order
+  const std::vector<double> &values() const;
+  // m x n and n x n, only if the vectors were requested
+  Matrix U() const;
+  Matrix V() const;
+
+  // Number of values above tolerance, max(m, n) eps s_max by default
+  int rank(double tolerance = -1) const;
+  // s_max / s_min, infinity for a singular matrix
+  double condition() const;
+  int sweeps() const;
+
+ private:
+  int _m;
+  int _n;
+  std::vector<double> _s;
+  // Rows are the columns of U and V
+  std::vector<double> _U;
+  std::vector<double> _V;
+  int _sweeps{0};
+};
+
+namespace Solver {
+std::vector<double> SingularValues(const Matrix &A, int workers = 1);
+}  // namespace Solver
@@ -0,0 +1,272 @@
+#include "symmetric.h"
+
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#include "parallel.h"
+#include "profiler.h"
+
+SymMatrix::SymMatrix(int n) : _n(n) {
+  if (n < 1) throw std::domain_error("SymMatrix error # 1");
+  _data.assign(static_cast<size_t>(n) * (n + 1) / 2, 0.0);
+}
+
+SymMatrix::SymMatrix(const Matrix &A) : SymMatrix(A.rows()) {
+  if (A.cols() != _n) throw std::domain_error("SymMatrix error # 2");
+  for (int j = 0; j < _n; ++j) {
+    double *p = row(j);
+    for (int i = 0; i <= j; ++i) p[i] = A[{i, j}];
+  }
+}
+
+int SymMatrix::size() const { return _n; }
+
+double &SymMatrix::at(int col, int row) {
+  if (col < 0 || col >= _n || row < 0 || row >= _n)
+    throw std::range_error("SymMatrix error # 3");
+  return col <= row ? this->row(row)[col] : this->row(col)[row];
+}
+
+double SymMatrix::at(int col, int row) const {
+  if (col < 0 || col >= _n || row < 0 || row >= _n)
+    throw std::range_error("SymMatrix error # 4");
+  return col <= row ? this->row(row)[col] : this->row(col)[row];
+}
+
+double *SymMatrix::row(int i) {
+  return _data.data() + static_cast<size_t>(i) * (i + 1) / 2;
+}
+
+const double *SymMatrix::row(int i) const {
+  return _data.data() + static_cast<size_t>(i) * (i + 1) / 2;
+}
+
+void SymMatrix::swap(int i, int j) {
+  if (i == j) return;
+  for (int k = 0; k < _n; ++k)
+    if (k != i && k != j) std::swap(at(k, i), at(k, j));
+  std::swap(at(i, i), at(j, j));
+}
+
+bool Solver::IsSymmetric(const Matrix &A) {
+  if (A.cols() != A.rows()) return false;
+  for (int j = 0; j < A.rows(); ++j)
+    for (int i = 0; i < j; ++i) {
+      double a = A[{i, j}];
+      double b = A[{j, i}];
+      if (std::abs(a - b) > 1e-14 * std::max(std::abs(a), std::abs(b)))
+        return false;
+    }
+  return true;
+}
+
+bool Solver::Cholesky(SymMatrix &A, int workers) {
+  LOG_DURATION("Cholesky decomposition time");
+  const int n = A.size();
+  const int nb = 64;
+  std::vector<double> panel(static_cast<size_t>(nb) * n);
+  for (int k0 = 0; k0 < n; k0 += nb) {
+    const int k1 = std::min(k0 + nb, n);
+    // Diagonal block, earlier blocks are already subtracted from it
+    for (int i = k0; i < k1; ++i) {
+      double *ri = A.row(i);
+      for (int j = k0; j <= i; ++j) {
+        const double *rj = A.row(j);
+        double s = ri[j];
+        for (int p = k0; p < j; ++p) s -= ri[p] * rj[p];
+        if (i != j) {
+          ri[j] = s / rj[j];
+        } else if (s > 0) {
+          ri[i] = sqrt(s);
+        } else {
+          return false;
+        }
+      }
+    }
+    if (k1 == n) break;
+
+    // Rows are dealt cyclically, so every worker gets a similar share of
+    // the triangular trailing matrix
+    Parallel(workers, [&A, n, k0, k1, workers](int w) {
+      for (int i = k1 + w; i < n; i += workers) {
+        double *ri = A.row(i);
+        for (int j = k0; j < k1; ++j) {
+          const double *rj = A.row(j);
+          double s = ri[j];
+          for (int p = k0; p < j; ++p) s -= ri[p] * rj[p];
+          ri[j] = s / rj[j];
+        }
+      }
+    });
+    // The panel is transposed, so the update below streams along rows
+    for (int p = k0; p < k1; ++p)
+      for (int j = k1; j < n; ++j) panel[(p - k0) * n + j] = A.row(j)[p];
+    Parallel(workers, [&A, &panel, n, k0, k1, workers](int w) {
+      const int tile = 256;
+      for (int t = k1; t < n; t += tile)
+        for (int i = k1 + w; i < n; i += workers) {
+          if (i < t) continue;
+          double *ri = A.row(i);
+          const int end = std::min(t + tile - 1, i);
+          for (int p = k0; p < k1; ++p) {
+            const double l = ri[p];
+            const double *pp = panel.data() + (p - k0) * n;
+            for (int j = t; j <= end; ++j) ri[j] -= l * pp[j];
+          }
+        }
+    });
+  }
+  return true;
+}
+
+void Solver::CholeskySolve(const SymMatrix &L, Matrix &B) {
+  const int n = L.size();
+  if (B.rows() != n) throw std::runtime_error("Solver error # 2");
+  std::vector<double> y(n);
+  for (int c = 0; c < B.cols(); ++c) {
+    for (int i = 0; i < n; ++i) {
+      const double *ri = L.row(i);
+      double s = B[{c, i}];
+      for (int p = 0; p < i; ++p) s -= ri[p] * y[p];
+      y[i] = s / ri[i];
+    }
+    for (int i = n - 1; i >= 0; --i) {
+      const double *ri = L.row(i);
+      y[i] /= ri[i];
+      for (int p = 0; p < i; ++p) y[p] -= ri[p] * y[i];
+    }
+    for (int i = 0; i < n; ++i) B[{c, i}] = y[i];
+  }
+}
+
+void Solver::LDLT(SymMatrix &A, std::vector<int> &perm,
+                  std::vector<int> &block) {
+  LOG_DURATION("LDLT decomposition time");
+  const int n = A.size();
+  const double alpha = (1 + sqrt(17.)) / 8;
+  perm.resize(n);
+  std::iota(perm.begin(), perm.end(), 0);
+  block.assign(n, 0);
+  std::vector<double> w1(n), w2(n);
+
+  for (int k = 0; k < n;) {
+    double absakk = std::abs(A.at(k, k));
+    double colmax = 0;
+    int imax = k;
+    for (int i = k + 1; i < n; ++i)
+      if (std::abs(A.row(i)[k]) > colmax) {
+        colmax = std::abs(A.row(i)[k]);
+        imax = i;
+      }
+    if (std::max(absakk, colmax) < 1e-14)
+      throw std::runtime_error("Solver error # 1");
+
+    int kp = k;
+    int kstep = 1;
+    if (absakk < alpha * colmax) {
+      double rowmax = 0;
+      for (int j = k; j < n; ++j)
+        if (j != imax) rowmax = std::max(rowmax, std::abs(A.at(j, imax)));
+      if (absakk * rowmax < alpha * colmax * colmax) {
+        kp = imax;
+        if (std::abs(A.at(imax, imax)) < alpha * rowmax) kstep = 2;
+      }
+    }
+    int kk = k + kstep - 1;
+    if (kp != kk) {
+      A.swap(kk, kp);
+      std::swap(perm[kk], perm[kp]);
+    }
+
+    if (kstep == 1) {
+      const double d = A.at(k, k);
+      for (int i = k + 1; i < n; ++i) w1[i] = A.row(i)[k];
+      for (int i = k + 1; i < n; ++i) {
+        double *ri = A.row(i);
+        const double l = w1[i] / d;
+        for (int j = k + 1; j <= i; ++j) ri[j] -= l * w1[j];
+        ri[k] = l;
+      }
+    } else {
+      const double a = A.at(k, k);
+      const double b = A.at(k, k + 1);
+      const double c = A.at(k + 1, k + 1);
+      const double det = a * c - b * b;
+      for (int i = k + 2; i < n; ++i) {
+        w1[i] = A.row(i)[k];
+        w2[i] = A.row(i)[k + 1];
+      }
+      for (int i = k + 2; i < n; ++i) {
+        double *ri = A.row(i);
+        const double l1 = (c * w1[i] - b * w2[i]) / det;
+        const double l2 = (a * w2[i] - b * w1[i]) / det;
+        for (int j = k + 2; j <= i; ++j) ri[j] -= l1 * w1[j] + l2 * w2[j];
+        ri[k] = l1;
+        ri[k + 1] = l2;
+      }
+    }
+    block[k] = kstep;
+    k += kstep;
+  }
+}
+
+void Solver::LDLTSolve(const SymMatrix &LD, const std::vector<int> &perm,
+                       const std::vector<int> &block, Matrix &B) {
+  const int n = LD.size();
+  if (B.rows() != n) throw std::runtime_error("Solver error # 2");
+  std::vector<double> z(n);
+  for (int c = 0; c < B.cols(); ++c) {
+    for (int i = 0; i < n; ++i) z[i] = B[{c, perm[i]}];
+    // L has a unit diagonal and no element inside a 2x2 block of D
+    for (int i = 0; i < n; ++i) {
+      const double *ri = LD.row(i);
+      double s = 0;
+      for (int p = 0; p < i; ++p) s += ri[p] * z[p];
+      if (block[i] == 0) s -= ri[i - 1] * z[i - 1];
+      z[i] -= s;
+    }
+    for (int k = 0; k < n; ++k)
+      if (block[k] == 1) {
+        z[k] /= LD.at(k, k);
+      } else if (block[k] == 2) {
+        const double a = LD.at(k, k);
+        const double b = LD.at(k, k + 1);
+        const double d = LD.at(k + 1, k + 1);
+        const double det = a * d - b * b;
+        const double z0 = z[k];
+        z[k] = (d * z0 - b * z[k + 1]) / det;
+        z[k + 1] = (a * z[k + 1] - b * z0) / det;
+      }
+    for (int i = n - 1; i > 0; --i) {
+      const double *ri = LD.row(i);
+      for (int p = 0; p < i; ++p) z[p] -= ri[p] * z[i];
+      if (block[i] == 0) z[i - 1] += ri[i - 1] * z[i];
+    }
+    for (int i = 0; i < n; ++i) B[{c, perm[i]}] = z[i];
+  }
+}
+
+void Solver::SolveSymmetric(const Matrix &A, const Matrix &B, Matrix &x) {
+  int n = x.rows();
+  if (B.rows() != n || A.cols() != n || A.rows() != n)
+    throw std::runtime_error("Solver error # 2");
+
+  LOG_DURATION("Algorithm symmetric time");
+  const int workers =
+      n < 512 ? 1 : std::max(1u, std::thread::hardware_concurrency());
+  Matrix _B(B);
+  SymMatrix S(A);
+  bool positive = true;
+  for (int i = 0; i < n && positive; ++i) positive = S.at(i, i) > 0;
+  if (positive && Cholesky(S, workers)) {
+    CholeskySolve(S, _B);
+  } else {
+    if (positive) S = SymMatrix(A);
+    std::vector<int> perm, block;
+    LDLT(S, perm, block);
+    LDLTSolve(S, perm, block, _B);
+  }
+  x = std::move(_B);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <vector>
+
+#include "matrix.h"
+
+// Symmetric matrix, only the lower triangle is stored, packed row by row:
+// row i keeps the elements (0, i) ... (i, i) contiguously.
+class SymMatrix {
+ public:
+  explicit SymMatrix(int n);
+  explicit SymMatrix(const Matrix &A);
+
+  int size() const;
+
+  double &at(int col, int row);
+  double at(int col, int row) const;
+  double *row(int i);
+  const double *row(int i) const;
+
+  // Symmetric permutation: swaps both rows and columns i and j
+  void swap(int i, int j);
+
+ private:
+  int _n;
+  std::vector<double> _data;
+};
+
+namespace Solver {
+bool IsSymmetric(const Matrix &A);
+
+// In place A = L L^T, returns false if A is not positive definite
+bool Cholesky(SymMatrix &A, int workers = 1);
+void CholeskySolve(const SymMatrix &L, Matrix &B);
+
+// In place P A P^T = L D L^T with Bunch-Kaufman pivoting, D consists of 1x1
+// and 2x2 blocks, block[k] is the size of the block starting at k (0 for
+// the second row of a 2x2 block). A singular A is Solver error # 1, as in
+// the general elimination.
+void LDLT(SymMatrix &A, std::vector<int> &perm, std::vector<int> &block);
+void LDLTSolve(const SymMatrix &LD, const std::vector<int> &perm,
+               const std::vector<int> &block, Matrix &B);
+
+void SolveSymmetric(const Matrix &A, const Matrix &B, Matrix &x);
+}  // namespace Solver
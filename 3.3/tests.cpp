@@ -1,8 +1,41 @@
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <new>
 #include <random>
+#include <thread>
 
+#include "batch.h"
+#include "cache.h"
+#include "ddouble.h"
+#include "distributed.h"
+#include "factorization.h"
 #include "matrix.h"
+#include "qr.h"
+#include "semiseparable.h"
+#include "service.h"
 #include "solver.h"
+#include "svd.h"
+#include "symmetric.h"
 #include "test_runner.h"
+#include "toeplitz.h"
+#include "utils.h"
+#include "woodbury.h"
+
+// Every heap allocation of the program, Matrix::allocations counts only
+// the buffers of matrices
+std::atomic<long> heap_allocations{0};
+
+void *operator new(std::size_t size) {
+  ++heap_allocations;
+  if (void *p = std::malloc(size ? size : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
 
 std::ostream &operator<<(std::ostream &os, const MatrixSize &s) {
   return os << "(" << s.col << ", " << s.row << ")";
@@ -296,6 +329,669 @@ void Solve() {
 
   for (int i = 0; i < n; ++i) ASSERT_EQUAL(x.at(0, i), output_x[i]);
 }
+
+void SolveAsync() {
+  int n = 3;
+  double input_A[] = {3, 2, -5, 2, -1, 3, 1, 2, -1};
+  double input_B[] = {-1, 13, 9};
+  double output_x[] = {3, 5, 4};
+
+  Matrix A(n, n, input_A);
+  A.release();
+  Matrix B(1, n, input_B);
+  B.release();
+
+  {
+    int calls = 0;
+    auto control = std::make_shared<Solver::Control>(
+        [&](int done, int total) {
+          ASSERT_EQUAL(done, calls);
+          ASSERT_EQUAL(total, n);
+          ++calls;
+        });
+    Matrix x = Solver::Async::Solve(A, B, control).get();
+    ASSERT_EQUAL(calls, n + 1);
+    for (int i = 0; i < n; ++i) ASSERT_EQUAL(x.at(0, i), output_x[i]);
+  }
+
+  {
+    auto control = std::make_shared<Solver::Control>();
+    control->cancel();
+    auto x = Solver::Async::Solve(A, B, control);
+    std::string error;
+    try {
+      x.get();
+    } catch (std::runtime_error &e) {
+      error = e.what();
+    }
+    ASSERT_EQUAL(error, "Solver error # 3");
+  }
+
+  {
+    auto control = std::make_shared<Solver::Control>();
+    control->set_deadline(Solver::Control::Clock::now());
+    auto x = Solver::Async::Solve(A, B, control);
+    std::string error;
+    try {
+      x.get();
+    } catch (std::runtime_error &e) {
+      error = e.what();
+    }
+    ASSERT_EQUAL(error, "Solver error # 4");
+  }
+}
+
+void SolveBatch() {
+  int n = 3;
+  double input_A[] = {3, 2, -5, 2, -1, 3, 1, 2, -1};
+  double input_B[] = {-1, 13, 9};
+  double output_x[] = {3, 5, 4};
+
+  Matrix A(n, n, input_A);
+  A.release();
+  Matrix B(1, n, input_B);
+  B.release();
+
+  for (int workers : {1, 3}) {
+    int count = 2 * Batch::kLanes + 3;
+    Batch batch(n, count);
+    for (int s = 0; s < count; ++s) {
+      batch.set(s, A, B);
+      // Scaling the whole system keeps the solution
+      for (int j = 0; j < n; ++j) {
+        for (int i = 0; i < n; ++i) batch.A(s, i, j) *= s + 1;
+        batch.b(s, j) *= s + 1;
+      }
+    }
+    // One singular system in the middle group leaves the rest solved
+    const int bad = Batch::kLanes + 2;
+    for (int i = 0; i < n; ++i) batch.A(bad, i, 1) = batch.A(bad, i, 0);
+    ASSERT_EQUAL(Solver::Solve(batch, workers), 1);
+    for (int s = 0; s < count; ++s) {
+      Matrix x = batch.solution(s);
+      ASSERT_EQUAL(batch.singular(s), s == bad);
+      for (int i = 0; i < n; ++i) {
+        if (s == bad) {
+          ASSERT(std::isnan(x.at(0, i)));
+        } else {
+          ASSERT_EQUAL(x.at(0, i), output_x[i]);
+        }
+      }
+    }
+  }
+}
+
+void Symmetric() {
+  // Generators from utils.cpp: k = 1 and k = 4 are positive definite
+  for (int k : {1, 2, 3, 4}) {
+    int n = 7;
+    Matrix A(n, [k, n](int i, int j) { return f(k, n, i, j); });
+    Matrix B(1, n);
+    for (int i = 0; i < n; i += 2) B += A.col(i);
+    ASSERT(Solver::IsSymmetric(A));
+
+    SymMatrix L(A);
+    ASSERT_EQUAL(Solver::Cholesky(L), k == 1 || k == 4);
+
+    SymMatrix LD(A);
+    std::vector<int> perm, block;
+    Solver::LDLT(LD, perm, block);
+    Matrix x = B;
+    Solver::LDLTSolve(LD, perm, block, x);
+    for (int i = 0; i < n; ++i)
+      ASSERT(std::abs(x.at(0, i) - (i % 2 == 0)) < 1e-6);
+
+    Matrix y(1, n);
+    Solver::Solve(A, B, y);
+    ASSERT(Solver::Discrepancy(A, B, y) < 1e-8);
+  }
+
+  {
+    int n = 150;
+    Matrix A(n, [n](int i, int j) {
+      return (i == j ? n : 0) + 1. / (1 + std::abs(i - j));
+    });
+    Matrix B(1, n, [](int, int j) { return j; });
+    for (int workers : {1, 3}) {
+      SymMatrix L(A);
+      ASSERT(Solver::Cholesky(L, workers));
+      Matrix x = B;
+      Solver::CholeskySolve(L, x);
+      ASSERT(Solver::Discrepancy(A, B, x) < 1e-10);
+    }
+  }
+
+  // A singular symmetric system fails with the code of the general path
+  {
+    Matrix A(3, [](int i, int j) { return (i + 1.0) * (j + 1.0); });
+    Matrix B(1, 3, [](int, int j) { return j; });
+    Matrix x(1, 3);
+    try {
+      Solver::Solve(A, B, x);
+      ASSERT(false);
+    } catch (std::runtime_error &e) {
+      ASSERT_EQUAL(std::string(e.what()), "Solver error # 1");
+    }
+  }
+}
+
+void Levinson() {
+  int n = 37;
+  std::vector<double> column(n), row(n);
+  for (int k = 0; k < n; ++k) {
+    column[k] = 1. / (1 + k);
+    row[k] = 0.5 / (1 + k * k);
+  }
+  column[0] = row[0] = 4;
+  Toeplitz T(column, row);
+  Matrix A(n, [&T](int i, int j) { return T.at(i, j); });
+  Matrix x0(1, n, [](int, int j) { return j % 3 - 1.0; });
+  Matrix B = A * x0;
+
+  {
+    auto detected = Toeplitz::Detect(A);
+    ASSERT(detected.has_value());
+    Matrix TB = *detected * x0;
+    for (int i = 0; i < n; ++i)
+      ASSERT(std::abs(TB.at(0, i) - B.at(0, i)) < 1e-12);
+  }
+
+  {
+    Matrix x = B;
+    ASSERT(Solver::Levinson(T, x));
+    for (int i = 0; i < n; ++i)
+      ASSERT(std::abs(x.at(0, i) - x0.at(0, i)) < 1e-12);
+    ASSERT(Solver::Discrepancy(T, B, x) < 1e-10);
+  }
+
+  {
+    // |i - j| has a zero diagonal, Levinson breaks down at the first step
+    Matrix A3(n, [n](int i, int j) { return f(3, n, i, j); });
+    ASSERT(Toeplitz::Detect(A3).has_value());
+    Matrix x = B;
+    ASSERT(!Solver::Levinson(*Toeplitz::Detect(A3), x));
+    ASSERT(!Toeplitz::Detect(Matrix(n, [n](int i, int j) {
+              return f(1, n, i, j);
+            })).has_value());
+
+    // Solve then takes it to SolveSymmetric, told apart by its timing log
+    std::ostringstream log;
+    std::streambuf *old = std::cerr.rdbuf(log.rdbuf());
+    Matrix y(1, n);
+    Solver::Solve(A3, B, y);
+    std::cerr.rdbuf(old);
+    ASSERT(log.str().find("Algorithm symmetric time") != std::string::npos);
+    ASSERT(log.str().find("Algorithm full time") == std::string::npos);
+    ASSERT(Solver::Discrepancy(A3, B, y) < 1e-8);
+  }
+
+  // Solve keeps Levinson to symmetric matrices with a positive diagonal
+  // and checks its residual: a breakdown, a nearly singular leading minor
+  // and a nonsymmetric matrix all go on to the other solvers
+  for (double gap : {0.0, 1e-9}) {
+    int m = 8;
+    std::vector<double> t(m);
+    t[0] = 1;
+    t[1] = 1 - gap;
+    for (int k = 2; k < m; ++k) t[k] = 0.3 * std::sin(k);
+    Toeplitz S(t, t);
+    Matrix AS(m, [&S](int i, int j) { return S.at(i, j); });
+    Matrix BS(1, m, [](int, int j) { return 1.0 + j; });
+    Matrix x(1, m);
+    Solver::Solve(AS, BS, x);
+    ASSERT(Solver::Discrepancy(AS, BS, x) < 1e-10);
+  }
+  {
+    Matrix x(1, n);
+    Solver::Solve(A, B, x);
+    for (int i = 0; i < n; ++i)
+      ASSERT(std::abs(x.at(0, i) - x0.at(0, i)) < 1e-12);
+  }
+}
+
+void SolveSemiseparable() {
+  for (int k : {1, 2}) {
+    int n = 9;
+    auto S = Semiseparable::FromGenerator(k, n);
+    Matrix A(n, [k, n](int i, int j) { return f(k, n, i, j); });
+    Matrix x0(1, n, [](int, int j) { return j * j - 3.0; });
+    Matrix B = A * x0;
+
+    Matrix SB = S * x0;
+    for (int i = 0; i < n; ++i) ASSERT_EQUAL(SB.at(0, i), B.at(0, i));
+
+    Matrix x(1, n);
+    Solver::Solve(S, B, x);
+    for (int i = 0; i < n; ++i) ASSERT_EQUAL(x.at(0, i), x0.at(0, i));
+    ASSERT(Solver::Discrepancy(S, B, x) < 1e-10);
+  }
+}
+
+void DoubleDouble() {
+  {
+    DDouble third = DDouble{1.0, 0.0} / DDouble{3.0, 0.0};
+    DDouble one = third * 3.0;
+    ASSERT_EQUAL(one.hi, 1.0);
+    ASSERT(std::abs(one.lo) < 1e-31);
+    ASSERT(std::abs((third * 3.0 - DDouble{1.0, 0.0}).hi) < 1e-31);
+  }
+
+  // Hilbert matrix scaled by lcm(1, ..., 19), so A and B are exact
+  int n = 10;
+  double lcm = 232792560;
+  Matrix A(n, [&](int i, int j) { return lcm / (i + j + 1); });
+  Matrix x0(1, n, [](int, int j) { return j % 2 == 0 ? 1.0 : -1.0; });
+  Matrix B = A * x0;
+
+  Matrix x(1, n);
+  Solver::Solve(A, B, x, Solver::Precision::DoubleDouble);
+  for (int i = 0; i < n; ++i)
+    ASSERT(std::abs(x.at(0, i) - x0.at(0, i)) < 1e-12);
+  ASSERT(Solver::Discrepancy(A, B, x, Solver::Precision::DoubleDouble) <
+         1e-20 * B.norm());
+
+  Matrix y(1, n);
+  Solver::Solve(A, B, y, Solver::Precision::Double);
+  ASSERT((y - x0).norm() > 1e3 * (x - x0).norm());
+}
+
+void LowRankUpdate() {
+  int n = 20;
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  Matrix A(n, [&](int i, int j) { return dist(gen) + (i == j) * n; });
+  Matrix b(1, n, [&](int, int) { return dist(gen); });
+
+  {
+    Factorization F(A);
+    Matrix x = b;
+    F.solve(x);
+    ASSERT(Solver::Discrepancy(A, b, x) < 1e-12);
+    // Singular input has the code of the direct pass
+    Matrix C(A);
+    C.row(3) *= 0.0;
+    try {
+      Factorization G(C);
+      ASSERT(false);
+    } catch (std::runtime_error &e) {
+      ASSERT_EQUAL(std::string(e.what()), "Solver error # 1");
+    }
+  }
+
+  LowRankSolver solver(A, 4);
+  Matrix x(1, n);
+  for (int step = 0; step < 6; ++step) {
+    Matrix U(2, n, [&](int, int) { return dist(gen); });
+    Matrix V(2, n, [&](int, int) { return dist(gen); });
+    solver.update(U, V);
+    solver.solve(b, x);
+    ASSERT(Solver::Discrepancy(solver.matrix(), b, x) < 1e-10);
+    ASSERT(solver.rank() <= 4);
+  }
+  // Rank grows by 2 per step and is reset every time it would pass 4
+  ASSERT_EQUAL(solver.refactorizations(), 2);
+}
+
+void Pivoting() {
+  int n = 3;
+  double input_A[] = {3, 2, -5, 2, -1, 3, 1, 2, -1};
+  double input_B[] = {-1, 13, 9};
+  double output_x[] = {3, 5, 4};
+
+  Matrix A(n, n, input_A);
+  A.release();
+  Matrix B(1, n, input_B);
+  B.release();
+
+  Matrix x(1, n);
+  Solver::Solve<Solver::Pivoting::Rook>(A, B, x);
+  for (int i = 0; i < n; ++i) ASSERT_EQUAL(x.at(0, i), output_x[i]);
+  Solver::Solve<Solver::Pivoting::Partial>(A, B, x);
+  for (int i = 0; i < n; ++i) ASSERT_EQUAL(x.at(0, i), output_x[i]);
+  Solver::Solve<Solver::Pivoting::None>(A, B, x);
+  for (int i = 0; i < n; ++i) ASSERT_EQUAL(x.at(0, i), output_x[i]);
+
+  {
+    auto full = Solver::Analyze<Solver::Pivoting::Full>(A, B);
+    auto partial = Solver::Analyze<Solver::Pivoting::Partial>(A, B);
+    ASSERT(full.growth >= 1 && full.residual < 1e-12);
+    ASSERT(partial.growth >= 1 && partial.residual < 1e-12);
+  }
+
+  {
+    double input_P[] = {0, 1, 1, 0};
+    Matrix P(2, 2, input_P);
+    P.release();
+    Matrix b(1, 2);
+    Matrix y(1, 2);
+    std::string error;
+    try {
+      Solver::Solve<Solver::Pivoting::None>(P, b, y);
+    } catch (std::runtime_error &e) {
+      error = e.what();
+    }
+    ASSERT_EQUAL(error, "Solver error # 1");
+    Solver::Solve<Solver::Pivoting::Rook>(P, b, y);
+  }
+}
+
+void Augmented() {
+  int n = 3;
+  double input_AB[] = {3, 2, -5, -1, 2, -1, 3, 13, 1, 2, -1, 9};
+  double output_AB[] = {1, -3. / 5, -2. / 5, 1. / 5, 0, 1,
+                        1. / 19, 62. / 19, 0, 0, 1, 5};
+  double output_x[] = {4, 3, 5};
+
+  Matrix AB(n + 1, n, input_AB);
+  AB.release();
+  Matrix x(1, n);
+
+  Solver::DirectAugmented(AB, x);
+  for (int i = 0; i <= n; ++i)
+    for (int j = 0; j < n; ++j)
+      ASSERT_EQUAL(AB.at(i, j), output_AB[j * (n + 1) + i]);
+
+  Solver::ReverseAugmented(AB);
+  for (int i = 0; i < n; ++i) ASSERT_EQUAL(AB.at(n, i), output_x[i]);
+}
+
+void LeastSquares() {
+  // Points on a line y = 2 x - 1 are fitted exactly
+  const int m = 200;
+  Matrix A(2, m, [](int i, int j) { return i == 0 ? 1.0 : j / 10.0; });
+  Matrix b(1, m, [](int, int j) { return 2 * (j / 10.0) - 1; });
+  Matrix x(1, 2);
+  double residual = Solver::LeastSquares(A, b, x);
+  ASSERT(std::abs(x[{0, 0}] + 1) < 1e-10);
+  ASSERT(std::abs(x[{0, 1}] - 2) < 1e-10);
+  ASSERT(residual < 1e-10);
+
+  // TSQR over row blocks agrees with the single factorization
+  const int n = 40;
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  Matrix C(n, 1000, [&](int, int) { return dist(gen); });
+  Matrix d(2, 1000, [&](int, int) { return dist(gen); });
+  Matrix y1(2, n), y4(2, n);
+  double r1 = Solver::LeastSquares(C, d, y1);
+  double r4 = Solver::LeastSquares(C, d, y4, 4);
+  y4 -= y1;
+  ASSERT(y4.norm() < 1e-8 * y1.norm());
+  ASSERT(std::abs(r1 - r4) < 1e-8 * r1);
+
+  // Too short for row blocks, the workers share the trailing updates
+  Matrix E = C.submat({0, 0}, {n - 1, 99});
+  Matrix g = d.submat({0, 0}, {1, 99});
+  Matrix z1(2, n), z3(2, n);
+  double s1 = Solver::LeastSquares(E, g, z1);
+  double s3 = Solver::LeastSquares(E, g, z3, 3);
+  z3 -= z1;
+  ASSERT(z3.norm() < 1e-10 * z1.norm());
+  ASSERT(std::abs(s1 - s3) < 1e-10 * s1);
+
+  // Q^T keeps the norm, R is triangular
+  QR qr(C, 8, 3);
+  Matrix R = qr.R();
+  ASSERT(R.cols() == n && R.rows() == n);
+  Matrix e(d);
+  qr.apply_qt(e);
+  ASSERT(std::abs(e.norm() - d.norm()) < 1e-10 * d.norm());
+  Matrix f(R.cols(), n, [&](int i, int j) { return R[{i, j}]; });
+  ASSERT(std::abs(f.norm() - C.norm()) < 1e-10 * C.norm());
+}
+
+void Singular() {
+  std::mt19937 gen(11);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  const int m = 90;
+  const int n = 61;
+  Matrix A(n, m, [&](int, int) { return dist(gen); });
+  SVD svd(A, 4);
+  const auto &s = svd.values();
+  for (int i = 1; i < n; ++i) ASSERT(s[i - 1] >= s[i]);
+  ASSERT(svd.rank() == n);
+
+  // U diag(s) V^T restores A, the serial sweep gives the same values
+  Matrix U = svd.U();
+  Matrix V = svd.V();
+  Matrix S(n, n, [&s](int i, int j) { return i == j ? s[i] : 0.0; });
+  Matrix Vt(n, n, [&V](int i, int j) { return V[{j, i}]; });
+  Matrix B = U * S * Vt;
+  B -= A;
+  ASSERT(B.norm() < 1e-12 * A.norm());
+  auto serial = Solver::SingularValues(A);
+  for (int i = 0; i < n; ++i) ASSERT(std::abs(serial[i] - s[i]) < 1e-12);
+
+  // Two equal columns leave one value at zero
+  Matrix C(A);
+  for (int j = 0; j < m; ++j) C[{5, j}] = C[{7, j}];
+  SVD deficient(C, 3, false);
+  ASSERT(deficient.rank() == n - 1);
+  ASSERT(deficient.condition() > 1e12);
+  ASSERT(svd.condition() < 1e3);
+
+  // Columns of 20000 entries meet the sqrt(m) eps test in a few sweeps
+  Matrix T(16, 20000, [&](int, int) { return dist(gen); });
+  ASSERT(SVD(T, 1, false).sweeps() <= 10);
+}
+
+void SolveWorkspace() {
+  const int n = 30;
+  std::mt19937 gen(5);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  Matrix A(n, [&](int i, int j) { return dist(gen) + (i == j) * 2; });
+  Matrix B(2, n, [&](int, int) { return dist(gen); });
+  Matrix expected(2, n);
+  Solver::Solve<Solver::Pivoting::Full>(A, B, expected);
+
+  // Smaller systems fit into the same workspace
+  Solver::Workspace workspace(n, 2);
+  Matrix x(2, n);
+  Matrix y(1, 10);
+  Matrix b = B.submat({0, 0}, {0, 9});
+  Matrix C = A.submat({0, 0}, {9, 9});
+  const long before = heap_allocations;
+  for (int r = 0; r < 10; ++r) {
+    Solver::Solve(A, B, x, workspace);
+    Solver::Solve<Solver::Pivoting::Partial>(C, b, y, workspace);
+  }
+  const long allocated = heap_allocations - before;
+  ASSERT_EQUAL(allocated, 0L);
+  x -= expected;
+  ASSERT(x.norm() < 1e-12);
+  ASSERT(Solver::Discrepancy(C, b, y) < 1e-12);
+
+  Solver::Workspace small(n - 1);
+  try {
+    Solver::Solve(A, B, x, small);
+    ASSERT(false);
+  } catch (std::runtime_error &e) {
+    ASSERT_EQUAL(std::string(e.what()), "Solver error # 10");
+  }
+}
+
+void SolveCached() {
+  const int n = 40;
+  std::mt19937 gen(3);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  Matrix A(n, [&](int, int) { return dist(gen); });
+  Matrix B(1, n, [&](int, int) { return dist(gen); });
+  Matrix C(1, n, [&](int, int) { return dist(gen); });
+  Matrix x(1, n);
+
+  // The second solve of (A, B) is a hit, (A, C) reuses the factorization
+  Cache cache(2);
+  Solver::Solve(A, B, x, cache);
+  ASSERT(Solver::Discrepancy(A, B, x) < 1e-10);
+  long misses = cache.misses();
+  Solver::Solve(A, B, x, cache);
+  Solver::Solve(A, C, x, cache);
+  ASSERT_EQUAL(cache.misses(), misses + 1);
+  ASSERT(Solver::Discrepancy(A, C, x) < 1e-10);
+
+  // Capacity 2: the oldest entry, the solution for B, is evicted
+  ASSERT_EQUAL(cache.size(), 2u);
+  ASSERT(!cache.solution(Cache::SystemKey(A, B)));
+  ASSERT(cache.solution(Cache::SystemKey(A, C)) != nullptr);
+  ASSERT(Hash(A) != Hash(B) && Hash(A) == Hash(Matrix(A)));
+
+  // Entries written to a directory are found by a new cache
+  auto directory = std::filesystem::temp_directory_path() / "solver_cache";
+  std::filesystem::remove_all(directory);
+  {
+    Cache persistent(4, directory.string());
+    persistent.store(Cache::GeneratorKey(n, 3), x);
+    Solver::Solve(A, B, x, persistent);
+  }
+  Cache restored(4, directory.string());
+  auto stored = restored.solution(Cache::GeneratorKey(n, 3));
+  ASSERT(stored && stored->rows() == n);
+  ASSERT(restored.factorization(Cache::MatrixKey(A)) != nullptr);
+  Matrix y(1, n);
+  Solver::Solve(A, B, y, restored);
+  ASSERT_EQUAL(restored.misses(), 0);
+  y -= x;
+  ASSERT_EQUAL(y.norm(), 0.0);
+  std::filesystem::remove_all(directory);
+
+  // A factorization of another matrix under the key of A, as after a
+  // collision, fails the residual check and is replaced
+  Matrix D(n, [&](int, int) { return dist(gen); });
+  Cache collided(4);
+  collided.store(Cache::MatrixKey(A),
+                 std::make_shared<const Factorization>(D));
+  Solver::Solve(A, B, y, collided);
+  ASSERT(Solver::Discrepancy(A, B, y) < 1e-10);
+  auto replaced = collided.factorization(Cache::MatrixKey(A));
+  Matrix z(B);
+  replaced->solve(z);
+  ASSERT(Solver::Discrepancy(A, B, z) < 1e-10);
+
+  // Symmetric systems keep their own solver, singular ones its error code
+  Matrix S(n, [](int i, int j) { return (i == j ? 40.0 : 0.0) + i + j; });
+  std::ostringstream log;
+  std::streambuf *old = std::cerr.rdbuf(log.rdbuf());
+  Solver::Solve(S, B, y, collided);
+  std::cerr.rdbuf(old);
+  ASSERT(log.str().find("Algorithm symmetric time") != std::string::npos);
+  ASSERT(Solver::Discrepancy(S, B, y) < 1e-10);
+  Matrix Z(n, [](int i, int j) { return (i + 1.0) * (j * j + 1.0); });
+  try {
+    Solver::Solve(Z, B, y, collided);
+    ASSERT(false);
+  } catch (std::runtime_error &e) {
+    ASSERT_EQUAL(std::string(e.what()), "Solver error # 1");
+  }
+}
+
+void Service() {
+  const int n = 50;
+  std::mt19937 gen(9);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  Matrix A(n, [&](int, int) { return dist(gen); });
+  Matrix B(1, n, [&](int, int) { return dist(gen); });
+  Matrix C(2, n, [&](int, int) { return dist(gen); });
+
+  const std::string path = "/tmp/solver_test.sock";
+  Server server(path, 2);
+  std::thread thread([&server] { server.run(); });
+  {
+    // The second system reuses the factorization of A
+    Client client(path);
+    Matrix x(1, n);
+    double residual = client.solve(A, B, x);
+    ASSERT(residual < 1e-10);
+    ASSERT(std::abs(residual - Solver::Discrepancy(A, B, x)) < 1e-12);
+    Matrix y(2, n);
+    ASSERT(client.solve(A, C, y) < 1e-10);
+    ASSERT(server.cache().hits() > 0);
+
+    // Errors of the solver come back with their own text
+    Matrix zero(n, [](int, int) { return 0.0; });
+    try {
+      client.solve(zero, B, x);
+      ASSERT(false);
+    } catch (std::runtime_error &e) {
+      ASSERT_EQUAL(std::string(e.what()), "Solver error # 1");
+    }
+    // A second client is served by the other worker
+    Client other(path);
+    SharedSystem system(n, 1);
+    Matrix sA = system.A();
+    Matrix sB = system.b();
+    sA += A;
+    sB += B;
+    ASSERT(other.solve(system) < 1e-10);
+    Matrix sx = system.x();
+    sx -= x;
+    ASSERT(sx.norm() == 0.0);
+  }
+  server.stop();
+  thread.join();
+
+  // With one worker a client idle between requests does not hold it
+  {
+    Server single(path, 1);
+    std::thread runner([&single] { single.run(); });
+    Client idle(path);
+    Matrix x(1, n);
+    ASSERT(idle.solve(A, B, x) < 1e-10);
+    Client busy(path);
+    Matrix y(2, n);
+    ASSERT(busy.solve(A, C, y) < 1e-10);
+    ASSERT(idle.solve(A, B, x) < 1e-10);
+    single.stop();
+    runner.join();
+  }
+
+  // Sizes whose segment would overflow are refused before it exists
+  for (int k : {1, 1 << 30}) {
+    try {
+      SharedSystem system(1 << 20, k);
+      ASSERT(false);
+    } catch (std::runtime_error &e) {
+      ASSERT_EQUAL(std::string(e.what()), "Service error # 3");
+    }
+  }
+}
+
+void SolveDistributed() {
+  const int n = 70;
+  std::mt19937 gen(13);
+  std::uniform_real_distribution<double> dist(-1, 1);
+  Matrix A(n, [&](int, int) { return dist(gen); });
+  Matrix B(2, n, [&](int, int) { return dist(gen); });
+  Matrix expected(2, n);
+  Solver::Solve<Solver::Pivoting::Partial>(A, B, expected);
+
+  // Block sizes that do not divide n, grids 1 x 1, 2 x 1 and 2 x 2
+  for (int processes : {1, 2, 4}) {
+    Matrix x(2, n);
+    Solver::SolveDistributed(A, B, x, processes, 16);
+    ASSERT(Solver::Discrepancy(A, B, x) < 1e-10);
+    x -= expected;
+    ASSERT(x.norm() < 1e-10);
+  }
+
+  Matrix C(A);
+  C.row(5) *= 0.0;
+  Matrix x(2, n);
+  try {
+    Solver::SolveDistributed(C, B, x, 2, 8);
+    ASSERT(false);
+  } catch (std::runtime_error &e) {
+    ASSERT_EQUAL(std::string(e.what()), "Solver error # 1");
+  }
+
+  // Another child of the caller ending meanwhile keeps its exit status
+  pid_t other = fork();
+  if (other == 0) _exit(7);
+  Matrix y(2, n);
+  Solver::SolveDistributed(A, B, y, 2, 16);
+  int status = 0;
+  ASSERT_EQUAL(waitpid(other, &status, 0), other);
+  ASSERT(WIFEXITED(status) && WEXITSTATUS(status) == 7);
+}
 }  // namespace Test_Solver
 
 int main() {
@@ -309,5 +1005,20 @@ int main() {
   RUN_TEST(tr, Test_Solver::Direct);
   RUN_TEST(tr, Test_Solver::Reverse);
   RUN_TEST(tr, Test_Solver::Solve);
+  RUN_TEST(tr, Test_Solver::SolveAsync);
+  RUN_TEST(tr, Test_Solver::SolveBatch);
+  RUN_TEST(tr, Test_Solver::Symmetric);
+  RUN_TEST(tr, Test_Solver::Levinson);
+  RUN_TEST(tr, Test_Solver::SolveSemiseparable);
+  RUN_TEST(tr, Test_Solver::DoubleDouble);
+  RUN_TEST(tr, Test_Solver::LowRankUpdate);
+  RUN_TEST(tr, Test_Solver::Pivoting);
+  RUN_TEST(tr, Test_Solver::Augmented);
+  RUN_TEST(tr, Test_Solver::LeastSquares);
+  RUN_TEST(tr, Test_Solver::Singular);
+  RUN_TEST(tr, Test_Solver::SolveWorkspace);
+  RUN_TEST(tr, Test_Solver::SolveCached);
+  RUN_TEST(tr, Test_Solver::Service);
+  RUN_TEST(tr, Test_Solver::SolveDistributed);
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "toeplitz.h"
+
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+
+#include "profiler.h"
+
+using Complex = std::complex<double>;
+
+Toeplitz::Toeplitz(int n) : _n(n) {
+  if (n < 1) throw std::domain_error("Toeplitz error # 1");
+  _t.assign(2 * n - 1, 0.0);
+}
+
+Toeplitz::Toeplitz(const std::vector<double> &column,
+                   const std::vector<double> &row)
+    : Toeplitz(column.size()) {
+  if (row.size() != column.size() || row[0] != column[0])
+    throw std::domain_error("Toeplitz error # 2");
+  for (int k = 0; k < _n; ++k) {
+    t(k) = column[k];
+    t(-k) = row[k];
+  }
+}
+
+std::optional<Toeplitz> Toeplitz::Detect(const Matrix &A) {
+  const int n = A.rows();
+  if (A.cols() != n) return std::nullopt;
+  for (int j = 1; j < n; ++j)
+    for (int i = 1; i < n; ++i) {
+      double a = A[{i, j}];
+      double b = A[{i - 1, j - 1}];
+      if (std::abs(a - b) > 1e-14 * std::max(std::abs(a), std::abs(b)))
+        return std::nullopt;
+    }
+
+  Toeplitz T(n);
+  for (int k = 0; k < n; ++k) {
+    T.t(k) = A[{0, k}];
+    T.t(-k) = A[{k, 0}];
+  }
+  return T;
+}
+
+int Toeplitz::size() const { return _n; }
+double &Toeplitz::t(int k) { return _t[_n - 1 + k]; }
+double Toeplitz::t(int k) const { return _t[_n - 1 + k]; }
+
+double Toeplitz::at(int col, int row) const {
+  if (col < 0 || col >= _n || row < 0 || row >= _n)
+    throw std::range_error("Toeplitz error # 3");
+  return t(row - col);
+}
+
+// Iterative radix-2 transform, the size of a must be a power of two
+void FFT(std::vector<Complex> &a, bool inverse) {
+  const int n = a.size();
+  for (int i = 1, j = 0; i < n; ++i) {
+    int bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(a[i], a[j]);
+  }
+
+  // Twiddles are computed directly, not by repeated multiplication, so the
+  // error does not grow with n
+  std::vector<Complex> root(n / 2);
+  const double sign = inverse ? 1 : -1;
+  for (int j = 0; j < n / 2; ++j)
+    root[j] = std::polar(1.0, sign * 2 * M_PI * j / n);
+
+  for (int len = 2; len <= n; len <<= 1) {
+    const int half = len / 2;
+    const int stride = n / len;
+    for (int i = 0; i < n; i += len)
+      for (int j = 0; j < half; ++j) {
+        const Complex w = root[j * stride];
+        const Complex u = a[i + j];
+        const Complex &x = a[i + j + half];
+        const Complex v(x.real() * w.real() - x.imag() * w.imag(),
+                        x.real() * w.imag() + x.imag() * w.real());
+        a[i + j] = u + v;
+        a[i + j + half] = u - v;
+      }
+  }
+  if (inverse)
+    for (auto &x : a) x /= n;
+}
+
+Matrix Toeplitz::operator*(const Matrix &x) const {
+  if (x.rows() != _n) throw std::domain_error("Toeplitz error # 4");
+  int m = 1;
+  while (m < 2 * _n - 1) m <<= 1;
+
+  // First column of the circulant matrix that holds T in its top left corner
+  std::vector<Complex> c(m);
+  for (int k = 0; k < _n; ++k) c[k] = t(k);
+  for (int k = 1; k < _n; ++k) c[m - k] = t(-k);
+  FFT(c, false);
+
+  Matrix result(x.cols(), _n);
+  std::vector<Complex> v(m);
+  for (int col = 0; col < x.cols(); ++col) {
+    std::fill(v.begin(), v.end(), 0.0);
+    for (int j = 0; j < _n; ++j) v[j] = x[{col, j}];
+    FFT(v, false);
+    for (int i = 0; i < m; ++i)
+      v[i] = Complex(v[i].real() * c[i].real() - v[i].imag() * c[i].imag(),
+                     v[i].real() * c[i].imag() + v[i].imag() * c[i].real());
+    FFT(v, true);
+    for (int j = 0; j < _n; ++j) result[{col, j}] = v[j].real();
+  }
+  return result;
+}
+
+bool Solver::Levinson(const Toeplitz &T, Matrix &B) {
+  LOG_DURATION("Levinson recursion time");
+  const int n = T.size();
+  const int K = B.cols();
+  if (B.rows() != n) throw std::runtime_error("Solver error # 2");
+  const double tol = 1e-12;
+
+  double max = 0;
+  for (int k = 1 - n; k < n; ++k) max = std::max(max, std::abs(T.t(k)));
+  if (std::abs(T.t(0)) <= tol * max) return false;
+
+  // For the leading m x m block: T f = e_0, T b = e_(m-1), T x = B
+  std::vector<double> f(n), b(n), x(static_cast<size_t>(n) * K);
+  f[0] = b[0] = 1 / T.t(0);
+  for (int c = 0; c < K; ++c) x[c] = B[{c, 0}] / T.t(0);
+
+  for (int m = 1; m < n; ++m) {
+    double ef = 0;
+    double eb = 0;
+    for (int j = 0; j < m; ++j) {
+      ef += T.t(m - j) * f[j];
+      eb += T.t(-j - 1) * b[j];
+    }
+    const double den = 1 - ef * eb;
+    if (std::abs(den) < tol) return false;
+
+    // f = ([f, 0] - ef [0, b]) / den, b = ([0, b] - eb [f, 0]) / den
+    for (int j = m; j >= 0; --j) {
+      const double fj = j < m ? f[j] : 0.0;
+      const double bj = j > 0 ? b[j - 1] : 0.0;
+      f[j] = (fj - ef * bj) / den;
+      b[j] = (bj - eb * fj) / den;
+    }
+
+    for (int c = 0; c < K; ++c) {
+      double ex = 0;
+      for (int j = 0; j < m; ++j) ex += T.t(m - j) * x[j * K + c];
+      const double r = B[{c, m}] - ex;
+      for (int j = 0; j <= m; ++j) x[j * K + c] += r * b[j];
+    }
+  }
+
+  for (int j = 0; j < n; ++j)
+    for (int c = 0; c < K; ++c) B[{c, j}] = x[j * K + c];
+  return true;
+}
+
+double Solver::Discrepancy(const Toeplitz &T, const Matrix &B,
+                           const Matrix &x) {
+  LOG_DURATION("Error calculation time");
+  Matrix result = T * x;
+  result -= B;
+  return result.norm();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <optional>
+#include <vector>
+
+#include "matrix.h"
+
+// Toeplitz matrix, constant along every diagonal: a(col, row) = t(row - col).
+// Only the 2n - 1 diagonal values are stored.
+class Toeplitz {
+ public:
+  explicit Toeplitz(int n);
+  // column is t(0) ... t(n - 1), row is t(0) ... t(-(n - 1))
+  Toeplitz(const std::vector<double> &column, const std::vector<double> &row);
+
+  static std::optional<Toeplitz> Detect(const Matrix &A);
+
+  int size() const;
+  double &t(int k);
+  double t(int k) const;
+  double at(int col, int row) const;
+
+  // O(n log n) product through a circulant embedding and the FFT
+  Matrix operator*(const Matrix &x) const;
+
+ private:
+  int _n;
+  std::vector<double> _t;
+};
+
+namespace Solver {
+// Levinson recursion in O(n^2), B is replaced by the solution. Returns false
+// without touching B if a leading principal minor is (nearly) singular.
+bool Levinson(const Toeplitz &T, Matrix &B);
+double Discrepancy(const Toeplitz &T, const Matrix &b, const Matrix &x);
+}  // namespace Solver
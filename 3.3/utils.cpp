@@ -1,6 +1,7 @@
 #include "utils.h"
 
 #include <stdexcept>
+#include <vector>
 
 double f(int k, int n, int i, int j) {
   switch (k) {
@@ -25,3 +26,27 @@ Matrix ReadMatrix(std::istream &is, int n) {
   }
   return Matrix(n, n, data);
 }
+
+void WriteBinary(std::ostream &os, const Matrix &A) {
+  const int shape[] = {A.cols(), A.rows()};
+  os.write(reinterpret_cast<const char *>(shape), sizeof(shape));
+  std::vector<double> row(A.cols());
+  for (int j = 0; j < A.rows(); ++j) {
+    for (int i = 0; i < A.cols(); ++i) row[i] = A[{i, j}];
+    os.write(reinterpret_cast<const char *>(row.data()),
+             sizeof(double) * row.size());
+  }
+  if (!os.good()) throw std::runtime_error("Utils error # 3");
+}
+
+Matrix ReadBinary(std::istream &is) {
+  int shape[2];
+  is.read(reinterpret_cast<char *>(shape), sizeof(shape));
+  if (!is.good() || shape[0] < 1 || shape[1] < 1)
+    throw std::runtime_error("Utils error # 4");
+  Matrix A(shape[0], shape[1]);
+  is.read(reinterpret_cast<char *>(&A[{0, 0}]),
+          sizeof(double) * shape[0] * shape[1]);
+  if (!is.good()) throw std::runtime_error("Utils error # 4");
+  return A;
+}
@@ -1,8 +1,12 @@
 #pragma once
 #include <istream>
+#include <ostream>
 #include <string>
 
 #include "matrix.h"
 
 double f(int k, int n, int i, int j);
-Matrix ReadMatrix(std::istream &is, int n);
\ No newline at end of file
+Matrix ReadMatrix(std::istream &is, int n);
+// Shape and elements as raw doubles, for files written by this program
+void WriteBinary(std::ostream &os, const Matrix &A);
+Matrix ReadBinary(std::istream &is);
@@ -0,0 +1,88 @@
+#include "woodbury.h"
+
+#include <stdexcept>
+
+#include "solver.h"
+
+LowRankSolver::LowRankSolver(const Matrix &A, int max_rank, double tolerance)
+    : LowRankSolver(A, Factorization(A), max_rank, tolerance) {}
+
+LowRankSolver::LowRankSolver(const Matrix &A, Factorization factorization,
+                             int max_rank, double tolerance)
+    : _A(A),
+      _factorization(std::move(factorization)),
+      _max_rank(max_rank),
+      _tolerance(tolerance) {
+  if (_factorization.size() != A.rows())
+    throw std::runtime_error("LowRankSolver error # 1");
+}
+
+void LowRankSolver::update(const Matrix &U, const Matrix &V) {
+  const int n = _A.rows();
+  if (U.rows() != n || V.rows() != n || U.cols() != V.cols())
+    throw std::runtime_error("LowRankSolver error # 2");
+
+  for (int j = 0; j < n; ++j)
+    for (int i = 0; i < n; ++i)
+      for (int c = 0; c < U.cols(); ++c) _A[{i, j}] += U[{c, j}] * V[{c, i}];
+  if (rank() + U.cols() > _max_rank) {
+    refactor();
+    return;
+  }
+
+  for (int c = 0; c < U.cols(); ++c) {
+    _U.push_back(U.col(c));
+    _V.push_back(V.col(c));
+    _Z.push_back(_U.back());
+    _factorization.solve(_Z.back());
+  }
+  const int r = rank();
+  Matrix C(r, [this](int i, int j) {
+    double s = i == j;
+    for (int k = 0; k < _A.rows(); ++k) s += _V[j][{0, k}] * _Z[i][{0, k}];
+    return s;
+  });
+  _capacitance.emplace(C);
+}
+
+void LowRankSolver::solve(const Matrix &b, Matrix &x) {
+  solve_updated(b, x);
+  if (rank() == 0) return;
+  if (Solver::Discrepancy(_A, b, x) > _tolerance * b.norm()) {
+    refactor();
+    solve_updated(b, x);
+  }
+}
+
+const Matrix &LowRankSolver::matrix() const { return _A; }
+int LowRankSolver::rank() const { return _U.size(); }
+int LowRankSolver::refactorizations() const { return _refactorizations; }
+
+void LowRankSolver::refactor() {
+  _factorization = Factorization(_A);
+  _U.clear();
+  _V.clear();
+  _Z.clear();
+  _capacitance.reset();
+  ++_refactorizations;
+}
+
+// x = y - Z C^-1 V^T y, where y = A0^-1 b
+void LowRankSolver::solve_updated(const Matrix &b, Matrix &x) const {
+  const int n = _A.rows();
+  if (b.rows() != n) throw std::runtime_error("LowRankSolver error # 3");
+  Matrix y(b);
+  _factorization.solve(y);
+  if (rank() > 0) {
+    Matrix t(y.cols(), rank(), [&](int c, int i) {
+      double s = 0;
+      for (int k = 0; k < n; ++k) s += _V[i][{0, k}] * y[{c, k}];
+      return s;
+    });
+    _capacitance->solve(t);
+    for (int i = 0; i < rank(); ++i)
+      for (int c = 0; c < y.cols(); ++c)
+        y.col(c).add_scaled(_Z[i], -t[{c, i}]);
+  }
+  x = std::move(y);
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <optional>
+#include <vector>
+
+#include "factorization.h"
+#include "matrix.h"
+
+// Solves (A + U1 V1^T + U2 V2^T + ...) x = b with the Sherman-Morrison-
+// Woodbury formula on top of the factorization of A, O(n^2 k) per solve
+// instead of O(n^3). The history of updates is bounded by max_rank, and
+// A is refactored when the history is full or the relative residual of a
+// solution exceeds tolerance.
+class LowRankSolver {
+ public:
+  LowRankSolver(const Matrix &A, int max_rank = 16, double tolerance = 1e-10);
+  LowRankSolver(const Matrix &A, Factorization factorization,
+                int max_rank = 16, double tolerance = 1e-10);
+
+  // A += U V^T, U and V are n x k
+  void update(const Matrix &U, const Matrix &V);
+  void solve(const Matrix &b, Matrix &x);
+
+  const Matrix &matrix() const;
+  int rank() const;
+  int refactorizations() const;
+
+ private:
+  void refactor();
+  void solve_updated(const Matrix &b, Matrix &x) const;
+
+  Matrix _A;
+  Factorization _factorization;
+  int _max_rank;
+  double _tolerance;
+  int _refactorizations{0};
+  // Columns of the accumulated update and Z = A0^-1 U
+  std::vector<Matrix> _U;
+  std::vector<Matrix> _V;
+  std::vector<Matrix> _Z;
+  // Capacitance matrix I + V^T Z
+  std::optional<Factorization> _capacitance;
+};